@@ -0,0 +1,136 @@
+#include "CameraTransform.hpp"
+
+#include <cmath>
+
+#include "Simd.hpp"
+
+namespace eerium
+{
+
+namespace
+{
+
+// std::round for every lane: truncate, then step away from zero when the
+// dropped fraction is at least a half. The fraction is exact, unlike the sum in
+// trunc(v + copysign(0.5, v)), which rounds 0.49999997f up to 1.
+#if defined(EERIUM_SIMD_AVX2)
+__m256 RoundHalfAway(__m256 v)
+{
+    const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+    __m256 whole = _mm256_round_ps(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    __m256 away = _mm256_cmp_ps(_mm256_andnot_ps(sign_mask, _mm256_sub_ps(v, whole)), _mm256_set1_ps(0.5f), _CMP_GE_OQ);
+    __m256 step = _mm256_or_ps(_mm256_set1_ps(1.0f), _mm256_and_ps(v, sign_mask));
+    return _mm256_add_ps(whole, _mm256_and_ps(away, step));
+}
+#elif defined(EERIUM_SIMD_SSE2)
+// SSE2 has no round instruction; truncating through int32 is exact for any map size
+__m128 RoundHalfAway(__m128 v)
+{
+    const __m128 sign_mask = _mm_set1_ps(-0.0f);
+    __m128 whole = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+    __m128 away = _mm_cmpge_ps(_mm_andnot_ps(sign_mask, _mm_sub_ps(v, whole)), _mm_set1_ps(0.5f));
+    __m128 step = _mm_or_ps(_mm_set1_ps(1.0f), _mm_and_ps(v, sign_mask));
+    return _mm_add_ps(whole, _mm_and_ps(away, step));
+}
+#endif
+
+}  // namespace
+
+void CameraTransform::TileToPixel(std::span<const float> tile_x, std::span<const float> tile_y,
+                                  std::span<float> pixel_x, std::span<float> pixel_y) const
+{
+    const size_t count = tile_x.size();
+    size_t i = 0;
+
+#if defined(EERIUM_SIMD_AVX2)
+    const __m256 hw = _mm256_set1_ps(half_width);
+    const __m256 hh = _mm256_set1_ps(half_height);
+    const __m256 ox = _mm256_set1_ps(offset_x);
+    const __m256 oy = _mm256_set1_ps(offset_y);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 x = _mm256_loadu_ps(tile_x.data() + i);
+        __m256 y = _mm256_loadu_ps(tile_y.data() + i);
+        _mm256_storeu_ps(pixel_x.data() + i, _mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(x, y), hw), ox));
+        _mm256_storeu_ps(pixel_y.data() + i, _mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(x, y), hh), oy));
+    }
+#elif defined(EERIUM_SIMD_SSE2)
+    const __m128 hw = _mm_set1_ps(half_width);
+    const __m128 hh = _mm_set1_ps(half_height);
+    const __m128 ox = _mm_set1_ps(offset_x);
+    const __m128 oy = _mm_set1_ps(offset_y);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(tile_x.data() + i);
+        __m128 y = _mm_loadu_ps(tile_y.data() + i);
+        _mm_storeu_ps(pixel_x.data() + i, _mm_add_ps(_mm_mul_ps(_mm_sub_ps(x, y), hw), ox));
+        _mm_storeu_ps(pixel_y.data() + i, _mm_add_ps(_mm_mul_ps(_mm_add_ps(x, y), hh), oy));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        TileToPixel(tile_x[i], tile_y[i], pixel_x[i], pixel_y[i]);
+    }
+}
+
+void CameraTransform::PixelToTile(std::span<const float> pixel_x, std::span<const float> pixel_y,
+                                  std::span<float> tile_x, std::span<float> tile_y, bool round) const
+{
+    const size_t count = pixel_x.size();
+    size_t i = 0;
+
+#if defined(EERIUM_SIMD_AVX2)
+    const __m256 ihw = _mm256_set1_ps(inv_half_width);
+    const __m256 ihh = _mm256_set1_ps(inv_half_height);
+    const __m256 ox = _mm256_set1_ps(offset_x);
+    const __m256 oy = _mm256_set1_ps(offset_y);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 ax = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(pixel_x.data() + i), ox), ihw);
+        __m256 ay = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(pixel_y.data() + i), oy), ihh);
+        __m256 x = _mm256_mul_ps(_mm256_add_ps(ax, ay), half);
+        __m256 y = _mm256_mul_ps(_mm256_sub_ps(ay, ax), half);
+        if (round)
+        {
+            x = RoundHalfAway(x);
+            y = RoundHalfAway(y);
+        }
+        _mm256_storeu_ps(tile_x.data() + i, x);
+        _mm256_storeu_ps(tile_y.data() + i, y);
+    }
+#elif defined(EERIUM_SIMD_SSE2)
+    const __m128 ihw = _mm_set1_ps(inv_half_width);
+    const __m128 ihh = _mm_set1_ps(inv_half_height);
+    const __m128 ox = _mm_set1_ps(offset_x);
+    const __m128 oy = _mm_set1_ps(offset_y);
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 ax = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(pixel_x.data() + i), ox), ihw);
+        __m128 ay = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(pixel_y.data() + i), oy), ihh);
+        __m128 x = _mm_mul_ps(_mm_add_ps(ax, ay), half);
+        __m128 y = _mm_mul_ps(_mm_sub_ps(ay, ax), half);
+        if (round)
+        {
+            x = RoundHalfAway(x);
+            y = RoundHalfAway(y);
+        }
+        _mm_storeu_ps(tile_x.data() + i, x);
+        _mm_storeu_ps(tile_y.data() + i, y);
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        PixelToTile(pixel_x[i], pixel_y[i], tile_x[i], tile_y[i]);
+        if (round)
+        {
+            tile_x[i] = std::round(tile_x[i]);
+            tile_y[i] = std::round(tile_y[i]);
+        }
+    }
+}
+
+}  // namespace eerium
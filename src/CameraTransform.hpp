@@ -0,0 +1,58 @@
+#pragma once
+
+#include <span>
+
+namespace eerium
+{
+
+/**
+ * Isometric tile <-> screen pixel transform for the current camera.
+ *
+ *   pixel.x = (tile.x - tile.y) * half_width  + offset_x
+ *   pixel.y = (tile.x + tile.y) * half_height + offset_y
+ *
+ * The coefficients (and the inverse scale factors) are precomputed by Set(),
+ * which the owner calls only when the camera offset or zoom changes. The span
+ * versions transform whole arrays of coordinates with SSE2/AVX2.
+ */
+struct CameraTransform
+{
+    float half_width = 0.0f;
+    float half_height = 0.0f;
+    float offset_x = 0.0f;
+    float offset_y = 0.0f;
+    float inv_half_width = 0.0f;
+    float inv_half_height = 0.0f;
+
+    void Set(float tile_width, float tile_height, float new_offset_x, float new_offset_y)
+    {
+        half_width = tile_width / 2.0f;
+        half_height = tile_height / 2.0f;
+        offset_x = new_offset_x;
+        offset_y = new_offset_y;
+        inv_half_width = 1.0f / half_width;
+        inv_half_height = 1.0f / half_height;
+    }
+
+    void TileToPixel(float tile_x, float tile_y, float& pixel_x, float& pixel_y) const
+    {
+        pixel_x = (tile_x - tile_y) * half_width + offset_x;
+        pixel_y = (tile_x + tile_y) * half_height + offset_y;
+    }
+
+    void PixelToTile(float pixel_x, float pixel_y, float& tile_x, float& tile_y) const
+    {
+        float adjusted_x = (pixel_x - offset_x) * inv_half_width;
+        float adjusted_y = (pixel_y - offset_y) * inv_half_height;
+        tile_x = (adjusted_x + adjusted_y) * 0.5f;
+        tile_y = (adjusted_y - adjusted_x) * 0.5f;
+    }
+
+    // Batch versions; all spans must have the same size. Output may alias input.
+    void TileToPixel(std::span<const float> tile_x, std::span<const float> tile_y,
+                     std::span<float> pixel_x, std::span<float> pixel_y) const;
+    void PixelToTile(std::span<const float> pixel_x, std::span<const float> pixel_y,
+                     std::span<float> tile_x, std::span<float> tile_y, bool round = false) const;
+};
+
+}  // namespace eerium
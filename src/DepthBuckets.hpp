@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace eerium
+{
+
+/**
+ * Painter's order for isometric sprites in linear time.
+ *
+ * Every item is keyed by the iso diagonal it stands on (column + row), and
+ * everything on one diagonal is drawn before anything on the next. Since the
+ * keys are small integers, a counting sort over the diagonals replaces a
+ * comparison sort, so ordering stays O(items + diagonals) however many
+ * objects and entities there are. Items keep their insertion order within a
+ * diagonal, which lets callers layer e.g. objects below entities.
+ */
+template <typename T>
+class DepthBuckets
+{
+public:
+    // Diagonals are 0..diagonal_count-1; out of range keys are clamped
+    void Begin(int diagonal_count)
+    {
+        counts_.assign(static_cast<size_t>(diagonal_count > 0 ? diagonal_count : 1) + 1, 0);
+        keys_.clear();
+        items_.clear();
+    }
+
+    void Add(int diagonal, const T& item)
+    {
+        const int last = static_cast<int>(counts_.size()) - 2;
+        const uint32_t key = static_cast<uint32_t>(diagonal < 0 ? 0 : (diagonal > last ? last : diagonal));
+        keys_.push_back(key);
+        items_.push_back(item);
+        ++counts_[key + 1];
+    }
+
+    // Items in drawing order, valid until the next Begin()
+    std::span<const T> Sort()
+    {
+        // Prefix sums turn the counts into the first slot of every diagonal
+        for (size_t i = 1; i < counts_.size(); ++i)
+        {
+            counts_[i] += counts_[i - 1];
+        }
+        sorted_.resize(items_.size());
+        for (size_t i = 0; i < items_.size(); ++i)
+        {
+            sorted_[counts_[keys_[i]]++] = items_[i];
+        }
+        return sorted_;
+    }
+
+private:
+    std::vector<uint32_t> counts_;
+    std::vector<uint32_t> keys_;
+    std::vector<T> items_;
+    std::vector<T> sorted_;
+};
+
+}  // namespace eerium
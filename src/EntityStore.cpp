@@ -0,0 +1,175 @@
+#include "EntityStore.hpp"
+
+#include "Simd.hpp"
+
+namespace eerium
+{
+
+EntityId EntityStore::Create(float x, float y, float speed, sdl::Color color)
+{
+    EntityId id;
+    if (!free_ids_.empty())
+    {
+        id = free_ids_.back();
+        free_ids_.pop_back();
+    }
+    else
+    {
+        id = static_cast<EntityId>(sparse_.size());
+        sparse_.push_back(kNoIndex);
+    }
+
+    sparse_[id] = ids_.size();
+    ids_.push_back(id);
+    pos_x_.push_back(x);
+    pos_y_.push_back(y);
+    target_x_.push_back(x);
+    target_y_.push_back(y);
+    speed_.push_back(speed);
+    color_.push_back(color);
+    return id;
+}
+
+void EntityStore::Destroy(EntityId id)
+{
+    if (!IsAlive(id))
+    {
+        return;
+    }
+
+    // Swap the last entity into the freed slot to keep the columns dense
+    size_t index = sparse_[id];
+    size_t last = ids_.size() - 1;
+    if (index != last)
+    {
+        ids_[index] = ids_[last];
+        pos_x_[index] = pos_x_[last];
+        pos_y_[index] = pos_y_[last];
+        target_x_[index] = target_x_[last];
+        target_y_[index] = target_y_[last];
+        speed_[index] = speed_[last];
+        color_[index] = color_[last];
+        sparse_[ids_[index]] = index;
+    }
+
+    ids_.pop_back();
+    pos_x_.pop_back();
+    pos_y_.pop_back();
+    target_x_.pop_back();
+    target_y_.pop_back();
+    speed_.pop_back();
+    color_.pop_back();
+
+    sparse_[id] = kNoIndex;
+    free_ids_.push_back(id);
+}
+
+void EntityStore::Clear()
+{
+    ids_.clear();
+    pos_x_.clear();
+    pos_y_.clear();
+    target_x_.clear();
+    target_y_.clear();
+    speed_.clear();
+    color_.clear();
+    sparse_.clear();
+    free_ids_.clear();
+}
+
+void EntityStore::Reserve(size_t count)
+{
+    ids_.reserve(count);
+    pos_x_.reserve(count);
+    pos_y_.reserve(count);
+    target_x_.reserve(count);
+    target_y_.reserve(count);
+    speed_.reserve(count);
+    color_.reserve(count);
+    sparse_.reserve(count);
+}
+
+void EntityStore::Update(float dt)
+{
+    UpdateRange(0, ids_.size(), dt);
+}
+
+void EntityStore::UpdateRange(size_t begin, size_t end, float dt)
+{
+    size_t tail = UpdateSimd(begin, end, dt);
+    UpdateScalar(tail, end, dt);
+}
+
+void EntityStore::UpdateScalar(size_t begin, size_t end, float dt)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        MoveTowards(pos_x_[i], pos_y_[i], target_x_[i], target_y_[i], speed_[i] * dt);
+    }
+}
+
+// Same math as MoveTowards(), evaluated for every lane and merged with masks:
+//   arrive = step >= distance || distance <= kMoveMinDistance
+//   pos    = arrive ? target : pos + d * step / distance
+// Lanes with distance == 0 produce inf/nan in the ratio, but always arrive.
+size_t EntityStore::UpdateSimd(size_t begin, size_t end, float dt)
+{
+    size_t i = begin;
+    float* px = pos_x_.data();
+    float* py = pos_y_.data();
+    const float* tx = target_x_.data();
+    const float* ty = target_y_.data();
+    const float* speed = speed_.data();
+
+#if defined(EERIUM_SIMD_AVX2)
+    const __m256 dt_v = _mm256_set1_ps(dt);
+    const __m256 min_distance = _mm256_set1_ps(kMoveMinDistance);
+    for (; i + 8 <= end; i += 8)
+    {
+        __m256 x = _mm256_loadu_ps(px + i);
+        __m256 y = _mm256_loadu_ps(py + i);
+        __m256 target_x = _mm256_loadu_ps(tx + i);
+        __m256 target_y = _mm256_loadu_ps(ty + i);
+
+        __m256 dx = _mm256_sub_ps(target_x, x);
+        __m256 dy = _mm256_sub_ps(target_y, y);
+        __m256 distance = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+        __m256 step = _mm256_mul_ps(_mm256_loadu_ps(speed + i), dt_v);
+        __m256 ratio = _mm256_div_ps(step, distance);
+
+        __m256 arrive = _mm256_or_ps(_mm256_cmp_ps(step, distance, _CMP_GE_OQ),
+                                     _mm256_cmp_ps(distance, min_distance, _CMP_LE_OQ));
+        _mm256_storeu_ps(px + i, _mm256_blendv_ps(_mm256_add_ps(x, _mm256_mul_ps(dx, ratio)), target_x, arrive));
+        _mm256_storeu_ps(py + i, _mm256_blendv_ps(_mm256_add_ps(y, _mm256_mul_ps(dy, ratio)), target_y, arrive));
+    }
+#elif defined(EERIUM_SIMD_SSE2)
+    auto select = [](__m128 mask, __m128 if_true, __m128 if_false)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, if_true), _mm_andnot_ps(mask, if_false));
+    };
+
+    const __m128 dt_v = _mm_set1_ps(dt);
+    const __m128 min_distance = _mm_set1_ps(kMoveMinDistance);
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(px + i);
+        __m128 y = _mm_loadu_ps(py + i);
+        __m128 target_x = _mm_loadu_ps(tx + i);
+        __m128 target_y = _mm_loadu_ps(ty + i);
+
+        __m128 dx = _mm_sub_ps(target_x, x);
+        __m128 dy = _mm_sub_ps(target_y, y);
+        __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+        __m128 step = _mm_mul_ps(_mm_loadu_ps(speed + i), dt_v);
+        __m128 ratio = _mm_div_ps(step, distance);
+
+        __m128 arrive = _mm_or_ps(_mm_cmpge_ps(step, distance), _mm_cmple_ps(distance, min_distance));
+        _mm_storeu_ps(px + i, select(arrive, target_x, _mm_add_ps(x, _mm_mul_ps(dx, ratio))));
+        _mm_storeu_ps(py + i, select(arrive, target_y, _mm_add_ps(y, _mm_mul_ps(dy, ratio))));
+    }
+#endif
+
+    return i;
+}
+
+}  // namespace eerium
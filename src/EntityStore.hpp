@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "sdl/Color.hpp"
+
+namespace eerium
+{
+
+using EntityId = uint32_t;
+static constexpr EntityId kInvalidEntity = std::numeric_limits<EntityId>::max();
+
+// Distance within which a mover snaps onto its target
+static constexpr float kMoveMinDistance = 0.01f;
+
+// Single movement step towards a target: move by `step` along the straight
+// line, snapping onto the target once the step reaches it or the mover is
+// within kMoveMinDistance. Rounding would otherwise leave it a hair short,
+// and arrival is checked by comparing with the target exactly. This is the
+// scalar reference for EntityStore::Update().
+inline void MoveTowards(float& x, float& y, float target_x, float target_y, float step)
+{
+    float dx = target_x - x;
+    float dy = target_y - y;
+    float distance = std::sqrt(dx * dx + dy * dy);
+    if (step >= distance || distance <= kMoveMinDistance)
+    {
+        x = target_x;
+        y = target_y;
+    }
+    else
+    {
+        float ratio = step / distance;
+        x += dx * ratio;
+        y += dy * ratio;
+    }
+}
+
+/**
+ * Structure-of-arrays storage for moving units.
+ *
+ * Every component is a dense column indexed the same way, so the movement
+ * step runs as one batch over contiguous floats. Removal swaps the last
+ * entity into the hole; EntityIds stay stable and are mapped to dense
+ * indices through a sparse table.
+ */
+class EntityStore
+{
+public:
+    EntityId Create(float x, float y, float speed, sdl::Color color);
+    void Destroy(EntityId id);
+    void Clear();
+    void Reserve(size_t count);
+
+    bool IsAlive(EntityId id) const
+    {
+        return id < sparse_.size() && sparse_[id] != kNoIndex;
+    }
+
+    size_t Size() const { return ids_.size(); }
+    size_t IndexOf(EntityId id) const { return sparse_[id]; }
+
+    void SetTarget(EntityId id, float x, float y)
+    {
+        size_t index = sparse_[id];
+        target_x_[index] = x;
+        target_y_[index] = y;
+    }
+
+    // Advance every mover by speed * dt towards its target
+    void Update(float dt);
+    void UpdateRange(size_t begin, size_t end, float dt);
+
+    // Exact, as the movement step snaps onto the target
+    bool HasArrived(size_t index) const
+    {
+        return pos_x_[index] == target_x_[index] && pos_y_[index] == target_y_[index];
+    }
+
+    // Dense columns, valid for indices [0, Size())
+    const std::vector<EntityId>& GetIds() const { return ids_; }
+    std::vector<float>& PositionsX() { return pos_x_; }
+    std::vector<float>& PositionsY() { return pos_y_; }
+    std::vector<float>& TargetsX() { return target_x_; }
+    std::vector<float>& TargetsY() { return target_y_; }
+    const std::vector<float>& PositionsX() const { return pos_x_; }
+    const std::vector<float>& PositionsY() const { return pos_y_; }
+    const std::vector<float>& TargetsX() const { return target_x_; }
+    const std::vector<float>& TargetsY() const { return target_y_; }
+    const std::vector<float>& Speeds() const { return speed_; }
+    const std::vector<sdl::Color>& Colors() const { return color_; }
+
+private:
+    static constexpr size_t kNoIndex = std::numeric_limits<size_t>::max();
+
+    // Batch kernels over [begin, end); the SIMD one returns where the scalar tail starts
+    void UpdateScalar(size_t begin, size_t end, float dt);
+    size_t UpdateSimd(size_t begin, size_t end, float dt);
+
+    std::vector<float> pos_x_;
+    std::vector<float> pos_y_;
+    std::vector<float> target_x_;
+    std::vector<float> target_y_;
+    std::vector<float> speed_;  // tiles per second
+    std::vector<sdl::Color> color_;
+    std::vector<EntityId> ids_;
+
+    std::vector<size_t> sparse_;  // EntityId -> dense index
+    std::vector<EntityId> free_ids_;
+};
+
+}  // namespace eerium
@@ -0,0 +1,319 @@
+#include "FieldOfView.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+
+namespace eerium
+{
+
+namespace
+{
+
+// Integer division rounding towards negative / positive infinity, for b > 0
+int FloorDiv(int a, int b)
+{
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+int CeilDiv(int a, int b)
+{
+    return -FloorDiv(-a, b);
+}
+
+// One row of a quadrant scan: the tiles at `depth` between two slopes. Slopes
+// are exact fractions, num / den with den > 0, measured as column / depth.
+struct Row
+{
+    int depth;
+    int start_num;
+    int start_den;
+    int end_num;
+    int end_den;
+};
+
+}  // namespace
+
+void VisibleSet::Reset(int min_x, int min_y, int max_x, int max_y)
+{
+    first_chunk_x_ = min_x / TileMap::kChunkSize;
+    first_chunk_y_ = min_y / TileMap::kChunkSize;
+    chunks_x_ = max_x / TileMap::kChunkSize - first_chunk_x_ + 1;
+    chunks_y_ = max_y / TileMap::kChunkSize - first_chunk_y_ + 1;
+    chunks_.assign(static_cast<size_t>(chunks_x_) * chunks_y_, ChunkBits{});
+}
+
+int VisibleSet::ChunkIndex(int x, int y) const
+{
+    if (x < 0 || y < 0)
+    {
+        return -1;
+    }
+    const int chunk_x = x / TileMap::kChunkSize - first_chunk_x_;
+    const int chunk_y = y / TileMap::kChunkSize - first_chunk_y_;
+    if (chunk_x < 0 || chunk_y < 0 || chunk_x >= chunks_x_ || chunk_y >= chunks_y_)
+    {
+        return -1;
+    }
+    return chunk_y * chunks_x_ + chunk_x;
+}
+
+void VisibleSet::Set(int x, int y)
+{
+    // Only called for tiles inside the covered area
+    const int bit = BitOf(x, y);
+    chunks_[ChunkIndex(x, y)][bit / 64] |= uint64_t{1} << (bit % 64);
+}
+
+bool VisibleSet::IsVisible(int x, int y) const
+{
+    const int chunk = ChunkIndex(x, y);
+    if (chunk < 0)
+    {
+        return false;
+    }
+    const int bit = BitOf(x, y);
+    return (chunks_[chunk][bit / 64] >> (bit % 64)) & 1;
+}
+
+VisibleSet::ChunkBits VisibleSet::GetChunkBits(int chunk_x, int chunk_y) const
+{
+    const int x = chunk_x - first_chunk_x_;
+    const int y = chunk_y - first_chunk_y_;
+    if (x < 0 || y < 0 || x >= chunks_x_ || y >= chunks_y_)
+    {
+        return {};
+    }
+    return chunks_[static_cast<size_t>(y) * chunks_x_ + x];
+}
+
+size_t VisibleSet::Count() const
+{
+    size_t count = 0;
+    for (const ChunkBits& chunk : chunks_)
+    {
+        for (uint64_t word : chunk)
+        {
+            count += static_cast<size_t>(std::popcount(word));
+        }
+    }
+    return count;
+}
+
+void FieldOfView::SetMap(const TileMap& map)
+{
+    width_ = map.GetWidth();
+    height_ = map.GetHeight();
+    opaque_.clear();
+    opaque_.reserve(map.GetTiles().size());
+    for (const Tile& tile : map.GetTiles())
+    {
+        opaque_.push_back(TileBlocksSight(tile) ? 1 : 0);
+    }
+    for (Viewer& viewer : viewers_)
+    {
+        viewer.dirty = viewer.active;
+    }
+}
+
+void FieldOfView::SetOpaque(int x, int y, bool opaque)
+{
+    if (!InBounds(x, y) || (opaque_[Index(x, y)] != 0) == opaque)
+    {
+        return;
+    }
+    opaque_[Index(x, y)] = opaque ? 1 : 0;
+    for (Viewer& viewer : viewers_)
+    {
+        if (viewer.active && std::abs(viewer.x - x) <= viewer.radius && std::abs(viewer.y - y) <= viewer.radius)
+        {
+            viewer.dirty = true;
+        }
+    }
+}
+
+void FieldOfView::Clear()
+{
+    viewers_.clear();
+    free_ids_.clear();
+}
+
+ViewerId FieldOfView::AddViewer(int x, int y, int radius)
+{
+    ViewerId id;
+    if (!free_ids_.empty())
+    {
+        id = free_ids_.back();
+        free_ids_.pop_back();
+    }
+    else
+    {
+        id = static_cast<ViewerId>(viewers_.size());
+        viewers_.emplace_back();
+    }
+    Viewer& viewer = viewers_[id];
+    viewer.x = x;
+    viewer.y = y;
+    viewer.radius = std::max(0, radius);
+    viewer.active = true;
+    viewer.dirty = true;
+    return id;
+}
+
+void FieldOfView::RemoveViewer(ViewerId id)
+{
+    Viewer& viewer = viewers_[id];
+    if (!viewer.active)
+    {
+        return;
+    }
+    viewer.active = false;
+    viewer.dirty = false;
+    viewer.visible.Reset(0, 0, 0, 0);
+    free_ids_.push_back(id);
+}
+
+void FieldOfView::MoveViewer(ViewerId id, int x, int y)
+{
+    Viewer& viewer = viewers_[id];
+    if (viewer.x != x || viewer.y != y)
+    {
+        viewer.x = x;
+        viewer.y = y;
+        viewer.dirty = true;
+    }
+}
+
+void FieldOfView::SetRadius(ViewerId id, int radius)
+{
+    Viewer& viewer = viewers_[id];
+    radius = std::max(0, radius);
+    if (viewer.radius != radius)
+    {
+        viewer.radius = radius;
+        viewer.dirty = true;
+    }
+}
+
+size_t FieldOfView::Update(JobSystem* jobs)
+{
+    dirty_ids_.clear();
+    for (ViewerId id = 0; id < viewers_.size(); ++id)
+    {
+        if (viewers_[id].dirty)
+        {
+            dirty_ids_.push_back(id);
+        }
+    }
+
+    // Every viewer only writes its own result, the opacity is shared read-only
+    auto compute = [this](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            Viewer& viewer = viewers_[dirty_ids_[i]];
+            Compute(viewer);
+            viewer.dirty = false;
+            ++viewer.version;
+        }
+    };
+    if (jobs)
+    {
+        jobs->ParallelFor(dirty_ids_.size(), kViewersPerJob, compute);
+    }
+    else
+    {
+        compute(0, dirty_ids_.size());
+    }
+    return dirty_ids_.size();
+}
+
+void FieldOfView::Compute(Viewer& viewer) const
+{
+    const int radius = viewer.radius;
+    const int origin_x = viewer.x;
+    const int origin_y = viewer.y;
+    VisibleSet& visible = viewer.visible;
+    if (!InBounds(origin_x, origin_y))
+    {
+        visible.Reset(0, 0, 0, 0);
+        return;
+    }
+    visible.Reset(std::max(origin_x - radius, 0), std::max(origin_y - radius, 0),
+                  std::min(origin_x + radius, width_ - 1), std::min(origin_y + radius, height_ - 1));
+    visible.Set(origin_x, origin_y);
+
+    // Rows still to scan; scanned depth first, so the stack stays short
+    thread_local std::vector<Row> rows;
+
+    // A little over radius^2 gives rounder edges than the exact circle
+    const int radius_squared = radius * radius + radius;
+
+    // Four quadrants, each scanned away from the origin row by row. A quadrant
+    // maps (depth, column) to a map tile; depth points north, east, south or west.
+    static constexpr int kQuadrants[4][4] = {
+        // depth_dx, depth_dy, col_dx, col_dy
+        {0, -1, 1, 0},
+        {1, 0, 0, 1},
+        {0, 1, 1, 0},
+        {-1, 0, 0, 1},
+    };
+    for (const auto& quadrant : kQuadrants)
+    {
+        rows.clear();
+        rows.push_back({1, -1, 1, 1, 1});
+        while (!rows.empty())
+        {
+            Row row = rows.back();
+            rows.pop_back();
+            if (row.depth > radius)
+            {
+                continue;
+            }
+
+            // Columns whose centers lie between the slopes, ties rounded inwards
+            const int depth = row.depth;
+            const int min_col = FloorDiv(2 * depth * row.start_num + row.start_den, 2 * row.start_den);
+            const int max_col = CeilDiv(2 * depth * row.end_num - row.end_den, 2 * row.end_den);
+
+            bool has_previous = false;
+            bool previous_wall = false;
+            for (int col = min_col; col <= max_col; ++col)
+            {
+                const int x = origin_x + depth * quadrant[0] + col * quadrant[2];
+                const int y = origin_y + depth * quadrant[1] + col * quadrant[3];
+                const bool wall = IsOpaque(x, y);
+
+                // Walls are seen whenever they are scanned, floor tiles only when
+                // their center is inside the row's slopes, which keeps it symmetric
+                const bool symmetric = col * row.start_den >= depth * row.start_num &&
+                                       col * row.end_den <= depth * row.end_num;
+                if ((wall || symmetric) && InBounds(x, y) && depth * depth + col * col <= radius_squared)
+                {
+                    visible.Set(x, y);
+                }
+
+                // The left edge of this tile, as a slope
+                const int edge_num = 2 * col - 1;
+                const int edge_den = 2 * depth;
+                if (has_previous && previous_wall && !wall)
+                {
+                    row.start_num = edge_num;
+                    row.start_den = edge_den;
+                }
+                if (has_previous && !previous_wall && wall)
+                {
+                    rows.push_back({depth + 1, row.start_num, row.start_den, edge_num, edge_den});
+                }
+                has_previous = true;
+                previous_wall = wall;
+            }
+            if (has_previous && !previous_wall)
+            {
+                rows.push_back({depth + 1, row.start_num, row.start_den, row.end_num, row.end_den});
+            }
+        }
+    }
+}
+
+}  // namespace eerium
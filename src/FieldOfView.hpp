@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "JobSystem.hpp"
+#include "TileMap.hpp"
+
+namespace eerium
+{
+
+using ViewerId = uint32_t;
+
+/**
+ * Tiles visible from one viewer, as one bitset per map chunk.
+ *
+ * Only the chunks overlapping the viewer's square of interest are stored, so
+ * the size depends on the view radius and not on the map.
+ */
+class VisibleSet
+{
+public:
+    static constexpr int kChunkTiles = TileMap::kChunkSize * TileMap::kChunkSize;
+    using ChunkBits = std::array<uint64_t, kChunkTiles / 64>;
+
+    // Drop everything and cover the chunks overlapping [min_x, max_x] x [min_y, max_y]
+    void Reset(int min_x, int min_y, int max_x, int max_y);
+
+    void Set(int x, int y);
+    bool IsVisible(int x, int y) const;
+    size_t Count() const;
+
+    // Bits of one map chunk, all clear if the chunk is not covered
+    ChunkBits GetChunkBits(int chunk_x, int chunk_y) const;
+
+private:
+    // Index of the chunk holding (x, y), -1 if it is not covered
+    int ChunkIndex(int x, int y) const;
+    static int BitOf(int x, int y) { return (y % TileMap::kChunkSize) * TileMap::kChunkSize + x % TileMap::kChunkSize; }
+
+    int first_chunk_x_ = 0;
+    int first_chunk_y_ = 0;
+    int chunks_x_ = 0;
+    int chunks_y_ = 0;
+    std::vector<ChunkBits> chunks_;
+};
+
+/**
+ * Symmetric shadowcasting field of view for any number of viewers on one map.
+ *
+ * Keeps its own copy of which tiles block sight (TileBlocksSight()).
+ * Viewers keep their last result until they step onto another tile, change
+ * their radius or a tile within their radius starts or stops blocking sight;
+ * Update() recomputes only those. Visibility is symmetric: a floor tile is
+ * visible from the viewer exactly when the viewer would be visible from it.
+ */
+class FieldOfView
+{
+public:
+    static constexpr size_t kViewersPerJob = 4;
+
+    // Take the opacity of every tile from the map; every viewer is recomputed
+    void SetMap(const TileMap& map);
+
+    // Change the opacity of one tile; viewers that may see it are recomputed
+    void SetOpaque(int x, int y, bool opaque);
+    bool IsOpaque(int x, int y) const { return !InBounds(x, y) || opaque_[Index(x, y)] != 0; }
+
+    void Clear();
+    ViewerId AddViewer(int x, int y, int radius);
+    void RemoveViewer(ViewerId id);
+
+    // Cheap when the viewer stays on its tile, call it every tick
+    void MoveViewer(ViewerId id, int x, int y);
+    void SetRadius(ViewerId id, int radius);
+
+    /**
+     * @brief Recompute the viewers that need it
+     * @param jobs Spreads the viewers over the workers when given
+     * @return Number of viewers recomputed
+     */
+    size_t Update(JobSystem* jobs = nullptr);
+
+    bool CanSee(ViewerId id, int x, int y) const { return viewers_[id].visible.IsVisible(x, y); }
+    const VisibleSet& GetVisible(ViewerId id) const { return viewers_[id].visible; }
+
+    // Changes every time the viewer is recomputed, for caches built from its result
+    uint32_t GetVersion(ViewerId id) const { return viewers_[id].version; }
+
+private:
+    struct Viewer
+    {
+        int x = 0;
+        int y = 0;
+        int radius = 0;
+        bool active = false;
+        bool dirty = false;
+        uint32_t version = 0;
+        VisibleSet visible;
+    };
+
+    bool InBounds(int x, int y) const { return x >= 0 && y >= 0 && x < width_ && y < height_; }
+    size_t Index(int x, int y) const { return static_cast<size_t>(y) * width_ + x; }
+    void Compute(Viewer& viewer) const;
+
+    int width_ = 0;
+    int height_ = 0;
+    std::vector<uint8_t> opaque_;
+    std::vector<Viewer> viewers_;
+    std::vector<ViewerId> free_ids_;
+    std::vector<ViewerId> dirty_ids_;  // scratch for Update()
+};
+
+}  // namespace eerium
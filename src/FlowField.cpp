@@ -0,0 +1,68 @@
+#include "FlowField.hpp"
+
+namespace eerium
+{
+
+void FlowField::Build(const CostGrid& grid, GridPoint target, AStarSearch& search)
+{
+    width_ = grid.width;
+    height_ = grid.height;
+    target_ = target;
+    directions_.assign(static_cast<size_t>(width_) * height_, kNoDirection);
+
+    if (!grid.IsWalkable(target.x, target.y))
+    {
+        integration_.assign(directions_.size(), AStarSearch::kUnreachable);
+        return;
+    }
+
+    // Integration field: cost from every tile to the target
+    search.ComputeCosts(grid, target, SearchBounds::Of(grid), true, integration_);
+
+    // Direction field: the neighbor that continues the cheapest path. Blocked
+    // tiles get a direction too, so units standing on one can walk off it.
+    for (int y = 0; y < height_; ++y)
+    {
+        for (int x = 0; x < width_; ++x)
+        {
+            if (x == target.x && y == target.y)
+            {
+                continue;
+            }
+
+            uint32_t best_cost = AStarSearch::kUnreachable;
+            uint8_t best_direction = kNoDirection;
+            for (uint8_t direction = 0; direction < 8; ++direction)
+            {
+                const int dx = kSteps[direction][0];
+                const int dy = kSteps[direction][1];
+                const int nx = x + dx;
+                const int ny = y + dy;
+                if (!grid.IsWalkable(nx, ny))
+                {
+                    continue;
+                }
+                const bool diagonal = dx != 0 && dy != 0;
+                if (diagonal && (!grid.IsWalkable(nx, y) || !grid.IsWalkable(x, ny)))
+                {
+                    continue;  // no cutting blocked corners
+                }
+
+                const uint32_t remaining = integration_[Index(nx, ny)];
+                if (remaining == AStarSearch::kUnreachable)
+                {
+                    continue;
+                }
+                const uint32_t cost = remaining + grid.At(nx, ny) * (diagonal ? AStarSearch::kDiagonalStep : AStarSearch::kStraightStep);
+                if (cost < best_cost)
+                {
+                    best_cost = cost;
+                    best_direction = direction;
+                }
+            }
+            directions_[Index(x, y)] = best_direction;
+        }
+    }
+}
+
+}  // namespace eerium
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Pathfinder.hpp"
+
+namespace eerium
+{
+
+/**
+ * Steering field towards a single target tile.
+ *
+ * The integration field holds the cost of the cheapest path from every tile
+ * to the target; the direction field stores, per tile, the neighbor to step
+ * onto next. Both are computed once per target, after which any number of
+ * units can find their next tile with a single lookup.
+ */
+class FlowField
+{
+public:
+    /**
+     * @brief Compute both fields for a target
+     * @param search Search instance whose buffers are reused for the integration pass
+     */
+    void Build(const CostGrid& grid, GridPoint target, AStarSearch& search);
+
+    GridPoint GetTarget() const { return target_; }
+    bool InBounds(int x, int y) const { return x >= 0 && y >= 0 && x < width_ && y < height_; }
+
+    // Cost to the target in AStarSearch units, kUnreachable if there is no path
+    uint32_t GetCost(int x, int y) const { return integration_[Index(x, y)]; }
+
+    /**
+     * @brief Next tile on the way to the target
+     * @return false at the target, outside the grid or when the target is unreachable
+     */
+    bool NextStep(int x, int y, GridPoint& next) const
+    {
+        if (!InBounds(x, y))
+        {
+            return false;
+        }
+        uint8_t direction = directions_[Index(x, y)];
+        if (direction == kNoDirection)
+        {
+            return false;
+        }
+        next = {x + kSteps[direction][0], y + kSteps[direction][1]};
+        return true;
+    }
+
+private:
+    static constexpr uint8_t kNoDirection = 8;
+    static constexpr int kSteps[8][2] = {
+        {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+    size_t Index(int x, int y) const { return static_cast<size_t>(y) * width_ + x; }
+
+    int width_ = 0;
+    int height_ = 0;
+    GridPoint target_;
+    std::vector<uint32_t> integration_;
+    std::vector<uint8_t> directions_;  // index into kSteps, kNoDirection if none
+};
+
+}  // namespace eerium
@@ -1,16 +1,30 @@
 #include "Game.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <numbers>
 #include <print>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+#include "SDL3_image/SDL_image.h"
+#include "ui/Animator.hpp"
 using namespace eerium;
 
 //  | SDL_WINDOW_HIGH_PIXEL_DENSITY
 // SDL_WINDOW_FULLSCREEN
 
-Game::Game() : context_(SDL_INIT_VIDEO),
-               window_(kGameTitle, 800, 600, SDL_WINDOW_RESIZABLE),
-               renderer_(window_.Get(), nullptr)
+Game::Game(Options options) : context_(SDL_INIT_VIDEO),
+                              window_(kGameTitle, 800, 600, options.headless ? SDL_WINDOW_HIDDEN : SDL_WINDOW_RESIZABLE),
+                              renderer_(window_.Get(), options.headless && options.frames > 0 ? "software" : nullptr),
+                              iso_grid_(job_system_),
+                              options_(std::move(options))
 {
     current_state_ = State::MENU;
+    RegisterEventHandlers();
     last_update_time_ = SDL_GetPerformanceCounter();
     last_render_time_ = last_update_time_;
     std::println("Game initialized successfully");
@@ -18,6 +32,17 @@ Game::Game() : context_(SDL_INIT_VIDEO),
 
 void Game::Run()
 {
+    if (options_.frames > 0)
+    {
+        RunFrames();
+        return;
+    }
+    if (!options_.replay_path.empty())
+    {
+        RunReplay();
+        return;
+    }
+
     while (current_state_ != State::QUIT)
     {
         Uint64 current_time = SDL_GetPerformanceCounter();
@@ -37,60 +62,264 @@ void Game::Run()
         while (update_accumulator_ >= kUpdateIntervalSeconds)
         {
             Update();
+            // Sync point: jobs scheduled by this tick finish before the next tick or the render reads their results
+            job_system_.SyncFrame();
             update_accumulator_ -= kUpdateIntervalSeconds;
         }
+
+        // A session ends when the game leaves the playfield
+        if (recording_ && current_state_ != State::PLAYING)
+        {
+            StopRecording();
+        }
         
-        // Frame-limited rendering
+        // Frame-limited rendering, skipped entirely while nothing on screen changed
         double time_since_last_render = static_cast<double>(current_time - last_render_time_) / frequency;
-        if (time_since_last_render >= kRenderIntervalSeconds)
+        if (time_since_last_render >= kRenderIntervalSeconds && NeedsRender())
         {
+            // UI animations advance once per rendered frame
+            ui::Animator::Instance().Update(static_cast<float>(time_since_last_render));
             Render();
             last_render_time_ = current_time;
         }
         
-        // Small sleep to prevent busy waiting and reduce CPU usage
-        SDL_Delay(1);
+        if (NeedsRender())
+        {
+            // Small sleep to prevent busy waiting and reduce CPU usage
+            SDL_Delay(1);
+        }
+        else
+        {
+            // Idle screen: sleep until input arrives or the next fixed update is due
+            double until_update = kUpdateIntervalSeconds - update_accumulator_;
+            Sint32 timeout_ms = std::max(1, static_cast<int>(until_update * 1000.0));
+            SDL_WaitEventTimeout(nullptr, timeout_ms);
+        }
     }
 }
 
-void Game::HandleEvents()
+void Game::RunReplay()
 {
-    SDL_Event e;
-    while (SDL_PollEvent(&e))
+    InputLog log = InputLog::Load(options_.replay_path);
+    std::println("Replaying {} ticks from {}", log.GetTickCount(), options_.replay_path);
+
+    // Same map, camera and path timing as the recorded session
+    iso_grid_.SetDeterministic(true);
+    iso_grid_.SetViewportSize(static_cast<float>(log.GetViewportWidth()), static_cast<float>(log.GetViewportHeight()));
+    iso_grid_.Reset(log.GetSeed());
+    current_state_ = State::PLAYING;
+    session_ticks_ = 0;
+
+    const auto& entries = log.GetEntries();
+    size_t next_entry = 0;
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    const Uint64 start_time = SDL_GetPerformanceCounter();
+    while (current_state_ == State::PLAYING && session_ticks_ < log.GetTickCount())
     {
-        if (e.type == SDL_EVENT_QUIT)
+        // The window still has to be serviced, but the input comes from the log
+        SDL_Event event;
+        while (SDL_PollEvent(&event))
+        {
+            if (event.type == SDL_EVENT_QUIT)
+            {
+                current_state_ = State::QUIT;
+            }
+        }
+
+        // Route the events of this tick one at a time, they were coalesced when recorded
+        for (; next_entry < entries.size() && entries[next_entry].tick == session_ticks_; ++next_entry)
+        {
+            event_router_.Clear();
+            event_router_.Push(entries[next_entry].event);
+            event_router_.Dispatch(current_state_);
+        }
+        if (current_state_ != State::PLAYING)
+        {
+            break;
+        }
+
+        Update();
+        job_system_.SyncFrame();
+
+        if (!options_.headless)
+        {
+            // Render every tick and keep the recorded pace
+            ui::Animator::Instance().Update(static_cast<float>(kUpdateIntervalSeconds));
+            Render();
+            double due = static_cast<double>(session_ticks_) * kUpdateIntervalSeconds;
+            double elapsed = static_cast<double>(SDL_GetPerformanceCounter() - start_time) / frequency;
+            if (due > elapsed)
+            {
+                SDL_Delay(static_cast<Uint32>((due - elapsed) * 1000.0));
+            }
+        }
+    }
+
+    double seconds = static_cast<double>(SDL_GetPerformanceCounter() - start_time) / frequency;
+    std::println("Replayed {} ticks in {:.3f} s ({:.0f} ticks/s), state hash {:016x}", session_ticks_, seconds,
+                 static_cast<double>(session_ticks_) / std::max(seconds, 1e-9), iso_grid_.GetStateHash());
+    current_state_ = State::QUIT;
+}
+
+void Game::RunFrames()
+{
+    if (!SDL_CreateDirectory(options_.frame_dir.c_str()))
+    {
+        throw std::runtime_error("Failed to create frame directory " + options_.frame_dir + ": " + SDL_GetError());
+    }
+    const std::string log_path = options_.frame_dir + "/timings.csv";
+    std::ofstream timings(log_path);
+    if (!timings)
+    {
+        throw std::runtime_error("Failed to open timing log for writing: " + log_path);
+    }
+    timings << "frame,update_ms,record_ms,submit_ms,present_ms\n";
+
+    // Same map, NPCs and effects on every run; there is no input, the camera follows a fixed path
+    auto window_size = renderer_.GetWindowSize();
+    iso_grid_.SetDeterministic(true);
+    iso_grid_.SetViewportSize(window_size.width, window_size.height);
+    iso_grid_.Reset(kFrameScriptSeed);
+    current_state_ = State::PLAYING;
+    session_ticks_ = 0;
+    std::println("Rendering {} scripted frames to {}", options_.frames, options_.frame_dir);
+
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    auto ms_since = [frequency](Uint64 start)
+    {
+        return static_cast<double>(SDL_GetPerformanceCounter() - start) * 1000.0 / static_cast<double>(frequency);
+    };
+    double total_ms = 0.0;
+    double worst_ms = 0.0;
+    int frame = 0;
+    for (; frame < options_.frames && current_state_ == State::PLAYING; ++frame)
+    {
+        SDL_Event event;
+        while (SDL_PollEvent(&event))
+        {
+            if (event.type == SDL_EVENT_QUIT)
+            {
+                current_state_ = State::QUIT;
+            }
+        }
+
+        // One fixed update per frame, so frame n always shows the same tick
+        Uint64 start = SDL_GetPerformanceCounter();
+        Update();
+        job_system_.SyncFrame();
+        const double update_ms = ms_since(start);
+
+        // Circle the map once while zooming in and out twice: pans past the
+        // terrain cache margin and zoom changes both show up in the run
+        const float turn = 2.0f * std::numbers::pi_v<float> * static_cast<float>(frame) / options_.frames;
+        const float center_x = IsoGrid::kMapWidth / 2.0f;
+        const float center_y = IsoGrid::kMapHeight / 2.0f;
+        iso_grid_.LookAt(center_x + 0.3f * IsoGrid::kMapWidth * std::cos(turn),
+                         center_y + 0.3f * IsoGrid::kMapHeight * std::sin(turn), 1.0f + 0.4f * std::sin(2.0f * turn));
+
+        start = SDL_GetPerformanceCounter();
+        iso_grid_.Render(renderer_);
+        const double record_ms = ms_since(start);
+        start = SDL_GetPerformanceCounter();
+        renderer_.Flush();
+        const double submit_ms = ms_since(start);
+
+        // Read back outside the timed sections
+        if (frame % options_.dump_every == 0 || frame + 1 == options_.frames)
+        {
+            SaveFrame(frame);
+        }
+        start = SDL_GetPerformanceCounter();
+        SDL_RenderPresent(renderer_);
+        const double present_ms = ms_since(start);
+
+        const double frame_ms = update_ms + record_ms + submit_ms + present_ms;
+        total_ms += frame_ms;
+        worst_ms = std::max(worst_ms, frame_ms);
+        timings << std::format("{},{:.3f},{:.3f},{:.3f},{:.3f}\n", frame, update_ms, record_ms, submit_ms, present_ms);
+    }
+
+    std::println("Rendered {} frames, {:.3f} ms average, {:.3f} ms worst, state hash {:016x}", frame,
+                 total_ms / std::max(frame, 1), worst_ms, iso_grid_.GetStateHash());
+    current_state_ = State::QUIT;
+}
+
+void Game::SaveFrame(int frame)
+{
+    const std::string path = std::format("{}/frame_{:05}.png", options_.frame_dir, frame);
+    SDL_FlushRenderer(renderer_);  // the pixels must hold every submitted command
+    SDL_Surface* pixels = SDL_RenderReadPixels(renderer_, nullptr);
+    if (!pixels || !IMG_SavePNG(pixels, path.c_str()))
+    {
+        std::println(stderr, "Failed to save {}: {}", path, SDL_GetError());
+    }
+    SDL_DestroySurface(pixels);
+}
+
+void Game::RegisterEventHandlers()
+{
+    event_router_.SubscribeGlobal(SDL_EVENT_QUIT, [this](const SDL_Event&)
+                                  { current_state_ = State::QUIT; });
+
+    // The window contents need to be redrawn after any of these, even on static screens
+    // The camera keeps the player inside the window, so it needs the size as part of the game state
+    event_router_.SubscribeGlobal(SDL_EVENT_WINDOW_RESIZED, [this](const SDL_Event& e)
+                                  { iso_grid_.SetViewportSize(static_cast<float>(e.window.data1), static_cast<float>(e.window.data2)); });
+
+    for (Uint32 type : {SDL_EVENT_WINDOW_SHOWN, SDL_EVENT_WINDOW_EXPOSED, SDL_EVENT_WINDOW_RESIZED,
+                        SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED, SDL_EVENT_WINDOW_RESTORED})
+    {
+        event_router_.SubscribeGlobal(type, [this](const SDL_Event&)
+                                      { RequestRender(); });
+    }
+
+    // Menu
+    event_router_.Subscribe(State::MENU, SDL_EVENT_KEY_DOWN, [this](const SDL_Event& e)
+                            {
+        if (e.key.key == SDLK_ESCAPE)
         {
             current_state_ = State::QUIT;
             return;
         }
-        switch (current_state_)
+        menu_.HandleEvent(e); });
+    event_router_.Subscribe(State::MENU, {SDL_EVENT_MOUSE_MOTION, SDL_EVENT_MOUSE_BUTTON_DOWN},
+                            [this](const SDL_Event& e)
+                            { menu_.HandleEvent(e); });
+
+    // Help
+    event_router_.Subscribe(State::HELP, SDL_EVENT_KEY_DOWN, [this](const SDL_Event& e)
+                            {
+        if (e.key.key == SDLK_ESCAPE)
         {
-            case State::MENU:
-                if (e.type == SDL_EVENT_KEY_DOWN && e.key.key == SDLK_ESCAPE)
-                {
-                    current_state_ = State::QUIT;
-                    return;
-                }
-                menu_.HandleEvent(e);
-                break;
+            current_state_ = State::MENU;
+            return;
+        }
+        help_screen_.HandleEvent(e); });
+    event_router_.Subscribe(State::HELP, SDL_EVENT_MOUSE_WHEEL, [this](const SDL_Event& e)
+                            { help_screen_.HandleEvent(e); });
 
-            case State::HELP:
-                if (e.type == SDL_EVENT_KEY_DOWN && e.key.key == SDLK_ESCAPE)
-                {
-                    current_state_ = State::MENU;
-                }
-                break;
-            case State::PLAYING:
-                if (e.type == SDL_EVENT_KEY_DOWN && e.key.key == SDLK_ESCAPE)
-                {
-                    current_state_ = State::MENU;
-                }
-                iso_grid_.HandleEvent(e);
-                break;
-            case State::QUIT:
-                break;
+    // Playing
+    event_router_.Subscribe(State::PLAYING, SDL_EVENT_KEY_DOWN, [this](const SDL_Event& e)
+                            {
+        if (e.key.key == SDLK_ESCAPE)
+        {
+            current_state_ = State::MENU;
         }
+        iso_grid_.HandleEvent(e); });
+    event_router_.Subscribe(State::PLAYING, {SDL_EVENT_MOUSE_MOTION, SDL_EVENT_MOUSE_BUTTON_DOWN, SDL_EVENT_MOUSE_WHEEL},
+                            [this](const SDL_Event& e)
+                            { iso_grid_.HandleEvent(e); });
+}
+
+void Game::HandleEvents()
+{
+    // Collect (and coalesce) everything that arrived since the last frame, then route it
+    event_router_.Poll();
+    if (recording_)
+    {
+        RecordEvents();
     }
+    event_router_.Dispatch(current_state_);
 }
 
 void Game::Update()
@@ -106,14 +335,14 @@ void Game::Update()
                 menu_.Reset();
                 if (action.name == "start")
                 {
-                    iso_grid_.Reset();
+                    StartGame();
                     current_state_ = State::PLAYING;
                     return;
                 }
                 else if (action.name == "help")
                 {
                     current_state_ = State::HELP;
-                    StartGame();
+                    help_screen_.Reset();
                     return;
                 }
                 else if (action.name == "quit")
@@ -126,7 +355,8 @@ void Game::Update()
         break;
         case State::PLAYING:
             // Update with fixed timestep delta time
-            iso_grid_.Update();
+            iso_grid_.Update(static_cast<float>(kUpdateIntervalSeconds));
+            ++session_ticks_;
             break;
         case State::HELP:
             break;
@@ -137,7 +367,59 @@ void Game::Update()
 
 void Game::StartGame()
 {
-    iso_grid_.Reset();
+    auto window_size = renderer_.GetWindowSize();
+    iso_grid_.SetViewportSize(window_size.width, window_size.height);
+    iso_grid_.Reset(std::random_device{}());
+    session_ticks_ = 0;
+
+    if (!options_.record_path.empty())
+    {
+        // Recorded sessions have to replay exactly, see IsoGrid::SetDeterministic()
+        iso_grid_.SetDeterministic(true);
+        recording_.emplace(iso_grid_.GetSeed(), static_cast<int>(window_size.width), static_cast<int>(window_size.height));
+    }
+}
+
+void Game::RecordEvents()
+{
+    // Tagged with the update they are handled before
+    for (const SDL_Event& event : event_router_.GetFrameEvents())
+    {
+        recording_->Add(session_ticks_, event);
+    }
+}
+
+void Game::StopRecording()
+{
+    if (!recording_)
+    {
+        return;
+    }
+    recording_->SetTickCount(session_ticks_);
+    recording_->Save(options_.record_path);
+    std::println("Recorded {} ticks to {}, state hash {:016x}", session_ticks_, options_.record_path, iso_grid_.GetStateHash());
+    recording_.reset();
+}
+
+bool Game::NeedsRender() const
+{
+    if (render_requested_ || current_state_ != last_rendered_state_ || ui::Animator::Instance().IsAnimating())
+    {
+        return true;
+    }
+    switch (current_state_)
+    {
+        case State::MENU:
+            return menu_.IsDirty();
+        case State::PLAYING:
+            // The playfield animates continuously
+            return true;
+        case State::HELP:
+            return help_screen_.IsDirty();
+        case State::QUIT:
+            return false;
+    }
+    return true;
 }
 
 void Game::Render()
@@ -148,7 +430,7 @@ void Game::Render()
             menu_.Render(renderer_);
             break;
         case State::HELP:
-            renderer_.Clear();
+            help_screen_.Render(renderer_);
             break;
         case State::PLAYING:
             iso_grid_.Render(renderer_);
@@ -160,5 +442,8 @@ void Game::Render()
     // Render FPS counter on top of everything in all states
     fps_counter_.Render(renderer_);
 
-    SDL_RenderPresent(renderer_.Get());
+    renderer_.Present();
+
+    render_requested_ = false;
+    last_rendered_state_ = current_state_;
 }
@@ -2,11 +2,18 @@
 #include <SDL3/SDL.h>
 #include <SDL3_ttf/SDL_ttf.h>
 
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <string>
 
+#include "HelpScreen.hpp"
+#include "InputLog.hpp"
 #include "IsoGrid.hpp"
+#include "JobSystem.hpp"
 #include "MainMenu.hpp"
 #include "sdl/Context.hpp"
+#include "sdl/EventRouter.hpp"
 #include "sdl/FpsCounter.hpp"
 #include "sdl/Renderer.hpp"
 #include "sdl/ResourceManager.hpp"
@@ -25,32 +32,70 @@ public:
         HELP,
         QUIT
     };
+    static constexpr size_t kStateCount = static_cast<size_t>(State::QUIT) + 1;
 
-    Game();
+    struct Options
+    {
+        std::string record_path;  // save the input of every session started from the menu here
+        std::string replay_path;  // play a recorded session back instead of reading input
+        bool headless = false;    // replay without a visible window, as fast as possible
+
+        // Scripted frames for comparing render changes, see RunFrames()
+        int frames = 0;                    // render this many frames and quit, 0 to play normally
+        int dump_every = 60;               // save every n-th frame, and the last one, as a PNG
+        std::string frame_dir = "frames";  // where the PNGs and timings.csv go
+    };
+
+    explicit Game(Options options);
 
     void Run();
 
 private:
+    void RegisterEventHandlers();
     void HandleEvents();
     void Update();
     void Render();
 
+    // Render on demand: static screens only redraw when something marked them dirty
+    void RequestRender() { render_requested_ = true; }
+    bool NeedsRender() const;
+
     void StartGame();
 
+    // Input recording, see InputLog
+    void RecordEvents();
+    void StopRecording();
+    void RunReplay();
+
+    // Scripted session on a fixed seed, see Options::frames
+    void RunFrames();
+    void SaveFrame(int frame);
+
     // RAII SDL resources - order matters for destruction
     sdl::Context context_;
     sdl::Window window_;
     sdl::Renderer renderer_;
 
+    // Shared worker threads, outlives everything that schedules jobs
+    JobSystem job_system_;
+
     State current_state_ = State::MENU;
+    sdl::EventRouter<State, kStateCount> event_router_;
 
     // UI
     MainMenu menu_;
+    HelpScreen help_screen_;
     sdl::FpsCounter fps_counter_;
 
     // Playground
     IsoGrid iso_grid_;
 
+    // Recording and replay
+    Options options_;
+    std::optional<InputLog> recording_;
+    uint64_t session_ticks_ = 0;  // fixed updates since the session started
+    static constexpr uint32_t kFrameScriptSeed = 12345;
+
     // Timing constants
     static constexpr char kGameTitle[] = "Eerium";
     static constexpr double kUpdateIntervalSeconds = 1.0 / 50.0;  // 50 updates per second (20ms)
@@ -61,6 +106,10 @@ private:
     Uint64 last_update_time_ = 0;
     Uint64 last_render_time_ = 0;
     double update_accumulator_ = 0.0;
+
+    // Render-on-demand state
+    bool render_requested_ = true;
+    State last_rendered_state_ = State::QUIT;
 };
 
 }  // namespace eerium
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "HelpScreen.hpp"
+
+#include <algorithm>
+#include <print>
+
+#include "sdl/ResourceManager.hpp"
+
+using namespace eerium;
+
+namespace
+{
+
+constexpr const char* kHelpText =
+    "Eerium is a small isometric playground. Walk around the generated map and "
+    "try out whatever systems happen to be hooked up at the moment.\n"
+    "\n"
+    "Movement\n"
+    "Use the arrow keys to step diagonally across the grid, or click a tile with "
+    "the left mouse button to walk there. Right-click a tile to call every NPC "
+    "to it. Press P to switch between pixel-accurate picking of what is under "
+    "the cursor and picking the flat tile grid.\n"
+    "\n"
+    "Sight\n"
+    "Stone blocks the view. Tiles the player cannot see are shaded and the NPCs "
+    "on them are hidden; NPCs that can see the player stop to watch.\n"
+    "\n"
+    "Editing\n"
+    "Pick a brush with 1 (grass), 2 (dirt) or 3 (walls), then click or drag to "
+    "paint the map. Press 0 to put the brush away and walk again.\n"
+    "\n"
+    "Effects\n"
+    "Press R to make it rain. Right-clicking a tile sends up a burst of sparks "
+    "where the NPCs rally.\n"
+    "\n"
+    "Camera\n"
+    "The camera follows the player once it leaves the center of the screen. Use "
+    "the mouse wheel to zoom in and out. The minimap in the top right corner "
+    "shows the whole map and what the window shows of it; press M to hide it.\n"
+    "\n"
+    "Menus\n"
+    "Navigate with the arrow keys or the mouse, select with Enter, Space or a "
+    "click. Escape goes back, and quits from the main menu.\n"
+    "\n"
+    "This page\n"
+    "Scroll with the mouse wheel, the arrow keys, Page Up and Page Down.";
+
+}  // namespace
+
+HelpScreen::HelpScreen()
+{
+    text_font_ = sdl::ResourceManager::Instance().GetDefaultFont();
+    title_font_ = sdl::ResourceManager::Instance().GetFont("title");
+    if (!text_font_ || !title_font_)
+    {
+        std::println(stderr, "Failed to get the fonts");
+        return;
+    }
+
+    text_.SetFont(*text_font_);
+    text_.SetText(kHelpText);
+    text_.SetColor(sdl::kColorLightGrey);
+}
+
+void HelpScreen::Reset()
+{
+    scroll_ = 0.0f;
+    dirty_ = true;
+}
+
+void HelpScreen::ScrollBy(float dy)
+{
+    float new_scroll = std::clamp(scroll_ + dy, 0.0f, max_scroll_);
+    if (new_scroll != scroll_)
+    {
+        scroll_ = new_scroll;
+        dirty_ = true;
+    }
+}
+
+void HelpScreen::HandleEvent(const SDL_Event& event)
+{
+    if (event.type == SDL_EVENT_MOUSE_WHEEL)
+    {
+        ScrollBy(-event.wheel.y * kScrollStep);
+    }
+
+    if (event.type == SDL_EVENT_KEY_DOWN)
+    {
+        switch (event.key.key)
+        {
+            case SDLK_UP:
+                ScrollBy(-kScrollStep);
+                break;
+            case SDLK_DOWN:
+                ScrollBy(kScrollStep);
+                break;
+            case SDLK_PAGEUP:
+                ScrollBy(-page_height_);
+                break;
+            case SDLK_PAGEDOWN:
+                ScrollBy(page_height_);
+                break;
+        }
+    }
+}
+
+void HelpScreen::Render(sdl::Renderer& renderer)
+{
+    renderer.Clear();
+    dirty_ = false;
+
+    if (!text_font_ || !title_font_)
+    {
+        return;
+    }
+
+    auto window = renderer.GetWindowSize();
+    sdl::CommandBuffer& commands = renderer.Commands();
+    commands.SetLayer(sdl::CommandBuffer::kLayerUi);
+    renderer.RenderText("HELP", window.width / 2, 40, sdl::kColorRed, *title_font_, sdl::Renderer::TextAlign::CENTER);
+
+    // Re-layout only happens when the width actually changes
+    float text_width = std::min(kMaxTextWidth, window.width - 2 * kMargin);
+    text_.SetWidth(text_width);
+
+    float clip_bottom = window.height - kFooterHeight;
+    page_height_ = std::max(0.0f, clip_bottom - kTextTop);
+    max_scroll_ = std::max(0.0f, text_.GetHeight() - page_height_);
+    scroll_ = std::min(scroll_, max_scroll_);
+
+    SDL_Rect clip = {0, static_cast<int>(kTextTop), static_cast<int>(window.width), static_cast<int>(page_height_)};
+    commands.SetClip(&clip);
+    text_.Render(renderer, (window.width - text_width) / 2, kTextTop - scroll_, kTextTop, clip_bottom);
+    commands.SetClip(nullptr);
+
+    renderer.RenderText("Press Escape to return to the menu",
+                        window.width / 2, window.height - 60, sdl::kColorDarkGrey, *text_font_, sdl::Renderer::TextAlign::CENTER);
+}
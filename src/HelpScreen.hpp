@@ -0,0 +1,43 @@
+#pragma once
+#include <SDL3/SDL.h>
+
+#include <optional>
+
+#include "sdl/Font.hpp"
+#include "sdl/Renderer.hpp"
+#include "sdl/TextLayout.hpp"
+
+namespace eerium
+{
+
+class HelpScreen
+{
+public:
+    HelpScreen();
+    void Reset();
+    void HandleEvent(const SDL_Event& event);
+    void Render(sdl::Renderer& renderer);
+
+    // True when the screen needs to be redrawn
+    bool IsDirty() const { return dirty_; }
+
+private:
+    void ScrollBy(float dy);
+
+    static constexpr float kMargin = 60.0f;
+    static constexpr float kMaxTextWidth = 720.0f;
+    static constexpr float kTextTop = 140.0f;
+    static constexpr float kFooterHeight = 80.0f;
+    static constexpr float kScrollStep = 40.0f;
+
+    std::optional<sdl::Font> text_font_;
+    std::optional<sdl::Font> title_font_;
+    sdl::TextLayout text_;
+
+    float scroll_ = 0.0f;
+    float max_scroll_ = 0.0f;
+    float page_height_ = 0.0f;
+    bool dirty_ = true;
+};
+
+}  // namespace eerium
@@ -0,0 +1,616 @@
+#include "HierarchicalPathfinder.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace eerium
+{
+
+namespace
+{
+
+// Virtual abstract nodes for the query endpoints
+constexpr uint32_t kStartNode = UINT32_MAX - 1;
+constexpr uint32_t kGoalNode = UINT32_MAX - 2;
+
+size_t LocalIndex(const SearchBounds& bounds, GridPoint point)
+{
+    return static_cast<size_t>(point.y - bounds.min_y) * bounds.Width() + (point.x - bounds.min_x);
+}
+
+uint64_t PathKey(const CostGrid& grid, GridPoint start, GridPoint goal)
+{
+    uint64_t start_index = static_cast<uint64_t>(start.y) * grid.width + start.x;
+    uint64_t goal_index = static_cast<uint64_t>(goal.y) * grid.width + goal.x;
+    return (start_index << 32) | goal_index;
+}
+
+}  // namespace
+
+SearchBounds HierarchicalPathfinder::ClusterBounds(uint32_t cluster) const
+{
+    int min_x = static_cast<int>(cluster % clusters_x_) * kClusterSize;
+    int min_y = static_cast<int>(cluster / clusters_x_) * kClusterSize;
+    return {min_x, min_y, std::min(min_x + kClusterSize, grid_.width), std::min(min_y + kClusterSize, grid_.height)};
+}
+
+void HierarchicalPathfinder::Build(const CostGrid& grid, JobSystem* jobs)
+{
+    std::unique_lock lock(mutex_);
+
+    grid_ = grid;
+    clusters_x_ = (grid_.width + kClusterSize - 1) / kClusterSize;
+    clusters_y_ = (grid_.height + kClusterSize - 1) / kClusterSize;
+
+    nodes_.clear();
+    free_nodes_.clear();
+    cluster_nodes_.assign(static_cast<size_t>(clusters_x_) * clusters_y_, {});
+    vertical_borders_.assign(static_cast<size_t>(std::max(0, clusters_x_ - 1)) * clusters_y_, {});
+    horizontal_borders_.assign(static_cast<size_t>(clusters_x_) * std::max(0, clusters_y_ - 1), {});
+
+    for (int cy = 0; cy < clusters_y_; ++cy)
+    {
+        for (int cx = 0; cx < clusters_x_; ++cx)
+        {
+            if (cx + 1 < clusters_x_)
+            {
+                BuildBorder(cx, cy, true);
+            }
+            if (cy + 1 < clusters_y_)
+            {
+                BuildBorder(cx, cy, false);
+            }
+        }
+    }
+
+    std::vector<uint32_t> clusters(cluster_nodes_.size());
+    for (uint32_t cluster = 0; cluster < clusters.size(); ++cluster)
+    {
+        clusters[cluster] = cluster;
+    }
+    BuildIntraEdges(clusters, jobs);
+
+    std::lock_guard cache_lock(cache_mutex_);
+    cache_.clear();
+    cache_index_.clear();
+}
+
+void HierarchicalPathfinder::UpdateTiles(std::span<const TileCostChange> changes, JobSystem* jobs)
+{
+    std::unique_lock lock(mutex_);
+
+    struct BorderKey
+    {
+        int cx;
+        int cy;
+        bool vertical;
+        bool operator==(const BorderKey&) const = default;
+    };
+    std::vector<BorderKey> dirty_borders;
+    std::vector<uint32_t> dirty_clusters;
+
+    auto mark_border = [&](int cx, int cy, bool vertical, int neighbor_cx, int neighbor_cy)
+    {
+        dirty_borders.push_back({cx, cy, vertical});
+        dirty_clusters.push_back(static_cast<uint32_t>(neighbor_cy) * clusters_x_ + neighbor_cx);
+    };
+
+    for (const TileCostChange& change : changes)
+    {
+        const int x = change.tile.x;
+        const int y = change.tile.y;
+        if (!grid_.InBounds(x, y) || grid_.At(x, y) == change.cost)
+        {
+            continue;
+        }
+
+        grid_.cost[static_cast<size_t>(y) * grid_.width + x] = change.cost;
+        if (change.cost != 0 && change.cost < grid_.min_cost)
+        {
+            grid_.min_cost = change.cost;  // keep the heuristic admissible
+        }
+
+        // The tile's own cluster always needs new intra edges; tiles on the
+        // cluster edge also change the transitions of that border
+        const int cx = x / kClusterSize;
+        const int cy = y / kClusterSize;
+        const int local_x = x % kClusterSize;
+        const int local_y = y % kClusterSize;
+        dirty_clusters.push_back(ClusterOf(x, y));
+        if (local_x == kClusterSize - 1 && cx + 1 < clusters_x_)
+        {
+            mark_border(cx, cy, true, cx + 1, cy);
+        }
+        if (local_x == 0 && cx > 0)
+        {
+            mark_border(cx - 1, cy, true, cx - 1, cy);
+        }
+        if (local_y == kClusterSize - 1 && cy + 1 < clusters_y_)
+        {
+            mark_border(cx, cy, false, cx, cy + 1);
+        }
+        if (local_y == 0 && cy > 0)
+        {
+            mark_border(cx, cy - 1, false, cx, cy - 1);
+        }
+    }
+
+    if (dirty_clusters.empty())
+    {
+        return;
+    }
+
+    std::sort(dirty_clusters.begin(), dirty_clusters.end());
+    dirty_clusters.erase(std::unique(dirty_clusters.begin(), dirty_clusters.end()), dirty_clusters.end());
+
+    for (size_t i = 0; i < dirty_borders.size(); ++i)
+    {
+        const BorderKey& key = dirty_borders[i];
+        if (std::find(dirty_borders.begin(), dirty_borders.begin() + i, key) != dirty_borders.begin() + i)
+        {
+            continue;  // already rebuilt
+        }
+        ClearBorder(key.vertical ? VerticalBorder(key.cx, key.cy) : HorizontalBorder(key.cx, key.cy));
+        BuildBorder(key.cx, key.cy, key.vertical);
+    }
+
+    BuildIntraEdges(dirty_clusters, jobs);
+
+    InvalidateCache(dirty_clusters);
+}
+
+size_t HierarchicalPathfinder::GetNodeCount() const
+{
+    std::shared_lock lock(mutex_);
+    return nodes_.size() - free_nodes_.size();
+}
+
+uint32_t HierarchicalPathfinder::AddNode(GridPoint position)
+{
+    uint32_t id;
+    if (!free_nodes_.empty())
+    {
+        id = free_nodes_.back();
+        free_nodes_.pop_back();
+    }
+    else
+    {
+        id = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+
+    Node& node = nodes_[id];
+    node.position = position;
+    node.cluster = ClusterOf(position.x, position.y);
+    node.alive = true;
+    node.edges.clear();
+    cluster_nodes_[node.cluster].push_back(id);
+    return id;
+}
+
+void HierarchicalPathfinder::RemoveNode(uint32_t id)
+{
+    Node& node = nodes_[id];
+
+    // Drop every edge pointing back at this node before its id can be reused
+    auto drop_edges_to = [&](uint32_t from)
+    {
+        auto& edges = nodes_[from].edges;
+        edges.erase(std::remove_if(edges.begin(), edges.end(), [id](const Edge& edge)
+                                   { return edge.to == id; }),
+                    edges.end());
+    };
+    for (const Edge& edge : node.edges)
+    {
+        drop_edges_to(edge.to);
+    }
+
+    auto& members = cluster_nodes_[node.cluster];
+    members.erase(std::find(members.begin(), members.end(), id));
+    for (uint32_t member : members)
+    {
+        drop_edges_to(member);
+    }
+
+    node.alive = false;
+    node.edges.clear();
+    free_nodes_.push_back(id);
+}
+
+void HierarchicalPathfinder::ClearBorder(Border& border)
+{
+    for (uint32_t node : border.nodes)
+    {
+        RemoveNode(node);
+    }
+    border.nodes.clear();
+}
+
+void HierarchicalPathfinder::BuildBorder(int cx, int cy, bool vertical)
+{
+    Border& border = vertical ? VerticalBorder(cx, cy) : HorizontalBorder(cx, cy);
+
+    // Tiles on either side of the border, walked along its length
+    int begin = vertical ? cy * kClusterSize : cx * kClusterSize;
+    int end = std::min(begin + kClusterSize, vertical ? grid_.height : grid_.width);
+    int fixed = (vertical ? cx + 1 : cy + 1) * kClusterSize - 1;
+    auto side_a = [&](int i) -> GridPoint
+    { return vertical ? GridPoint{fixed, i} : GridPoint{i, fixed}; };
+    auto side_b = [&](int i) -> GridPoint
+    { return vertical ? GridPoint{fixed + 1, i} : GridPoint{i, fixed + 1}; };
+    auto open = [&](int i)
+    {
+        GridPoint a = side_a(i);
+        GridPoint b = side_b(i);
+        return grid_.IsWalkable(a.x, a.y) && grid_.IsWalkable(b.x, b.y);
+    };
+
+    auto add_transition = [&](int i)
+    {
+        GridPoint a = side_a(i);
+        GridPoint b = side_b(i);
+        uint32_t node_a = AddNode(a);
+        uint32_t node_b = AddNode(b);
+        nodes_[node_a].edges.push_back({node_b, grid_.At(b.x, b.y) * AStarSearch::kStraightStep});
+        nodes_[node_b].edges.push_back({node_a, grid_.At(a.x, a.y) * AStarSearch::kStraightStep});
+        border.nodes.push_back(node_a);
+        border.nodes.push_back(node_b);
+    };
+
+    int run_start = -1;
+    for (int i = begin; i <= end; ++i)
+    {
+        bool is_open = i < end && open(i);
+        if (is_open && run_start < 0)
+        {
+            run_start = i;
+        }
+        else if (!is_open && run_start >= 0)
+        {
+            int length = i - run_start;
+            if (length >= kLongEntrance)
+            {
+                add_transition(run_start);
+                add_transition(i - 1);
+            }
+            else
+            {
+                add_transition(run_start + length / 2);
+            }
+            run_start = -1;
+        }
+    }
+}
+
+void HierarchicalPathfinder::BuildIntraEdges(uint32_t cluster, AStarSearch& search, std::vector<uint32_t>& costs)
+{
+    const auto& members = cluster_nodes_[cluster];
+
+    // Keep the inter-cluster edges, recompute everything inside the cluster
+    for (uint32_t id : members)
+    {
+        auto& edges = nodes_[id].edges;
+        edges.erase(std::remove_if(edges.begin(), edges.end(), [&](const Edge& edge)
+                                   { return nodes_[edge.to].cluster == cluster; }),
+                    edges.end());
+    }
+
+    const SearchBounds bounds = ClusterBounds(cluster);
+    for (uint32_t from : members)
+    {
+        search.ComputeCosts(grid_, nodes_[from].position, bounds, false, costs);
+        for (uint32_t to : members)
+        {
+            if (to == from)
+            {
+                continue;
+            }
+            uint32_t cost = costs[LocalIndex(bounds, nodes_[to].position)];
+            if (cost != AStarSearch::kUnreachable)
+            {
+                nodes_[from].edges.push_back({to, cost});
+            }
+        }
+    }
+}
+
+void HierarchicalPathfinder::BuildIntraEdges(std::span<const uint32_t> clusters, JobSystem* jobs)
+{
+    // Clusters only touch the edges of their own nodes, so they can be built in parallel
+    auto build_range = [&](size_t begin, size_t end)
+    {
+        AStarSearch search;
+        std::vector<uint32_t> costs;
+        for (size_t i = begin; i < end; ++i)
+        {
+            BuildIntraEdges(clusters[i], search, costs);
+        }
+    };
+
+    if (jobs)
+    {
+        jobs->ParallelFor(clusters.size(), kClustersPerJob, build_range);
+    }
+    else
+    {
+        build_range(0, clusters.size());
+    }
+}
+
+bool HierarchicalPathfinder::FindPath(GridPoint start, GridPoint goal, Scratch& scratch, std::vector<GridPoint>& path) const
+{
+    std::shared_lock lock(mutex_);
+
+    path.clear();
+    if (!grid_.InBounds(start.x, start.y) || !grid_.IsWalkable(goal.x, goal.y))
+    {
+        return false;
+    }
+    if (start == goal)
+    {
+        return true;
+    }
+
+    // Short queries: plain A* in a window around both ends is cheaper than the graph
+    if (std::abs(goal.x - start.x) <= kClusterSize && std::abs(goal.y - start.y) <= kClusterSize)
+    {
+        constexpr int kPadding = kClusterSize / 2;
+        SearchBounds window = {
+            std::max(0, std::min(start.x, goal.x) - kPadding),
+            std::max(0, std::min(start.y, goal.y) - kPadding),
+            std::min(grid_.width, std::max(start.x, goal.x) + kPadding + 1),
+            std::min(grid_.height, std::max(start.y, goal.y) + kPadding + 1)};
+        if (scratch.search.FindPath(grid_, start, goal, window, path))
+        {
+            return true;
+        }
+    }
+
+    // A unit stuck on a blocked tile may step straight across a cluster border
+    // without passing a transition, which the abstract graph cannot express
+    if (!grid_.IsWalkable(start.x, start.y))
+    {
+        return scratch.search.FindPath(grid_, start, goal, path);
+    }
+
+    const uint64_t key = PathKey(grid_, start, goal);
+    if (LookupCache(key, path))
+    {
+        return true;
+    }
+
+    if (!FindAbstractPath(start, goal, scratch) || !RefinePath(start, goal, scratch, path))
+    {
+        path.clear();
+        return false;
+    }
+
+    StoreCache(key, path, start);
+    return true;
+}
+
+bool HierarchicalPathfinder::FindAbstractPath(GridPoint start, GridPoint goal, Scratch& scratch) const
+{
+    const uint32_t start_cluster = ClusterOf(start.x, start.y);
+    const uint32_t goal_cluster = ClusterOf(goal.x, goal.y);
+
+    // Connect the endpoints to the abstract nodes of their clusters
+    const SearchBounds start_bounds = ClusterBounds(start_cluster);
+    scratch.search.ComputeCosts(grid_, start, start_bounds, false, scratch.costs);
+    scratch.start_links.clear();
+    for (uint32_t id : cluster_nodes_[start_cluster])
+    {
+        uint32_t cost = scratch.costs[LocalIndex(start_bounds, nodes_[id].position)];
+        if (cost != AStarSearch::kUnreachable)
+        {
+            scratch.start_links.emplace_back(id, cost);
+        }
+    }
+    const uint32_t direct_cost = start_cluster == goal_cluster
+                                     ? scratch.costs[LocalIndex(start_bounds, goal)]
+                                     : AStarSearch::kUnreachable;
+
+    const SearchBounds goal_bounds = ClusterBounds(goal_cluster);
+    scratch.search.ComputeCosts(grid_, goal, goal_bounds, true, scratch.costs);
+    scratch.goal_links.clear();
+    for (uint32_t id : cluster_nodes_[goal_cluster])
+    {
+        uint32_t cost = scratch.costs[LocalIndex(goal_bounds, nodes_[id].position)];
+        if (cost != AStarSearch::kUnreachable)
+        {
+            scratch.goal_links.emplace(id, cost);
+        }
+    }
+
+    // A* over the abstract graph
+    auto position_of = [&](uint32_t id)
+    {
+        return id == kStartNode ? start : (id == kGoalNode ? goal : nodes_[id].position);
+    };
+    auto heuristic = [&](uint32_t id)
+    {
+        GridPoint p = position_of(id);
+        uint32_t dx = static_cast<uint32_t>(std::abs(p.x - goal.x));
+        uint32_t dy = static_cast<uint32_t>(std::abs(p.y - goal.y));
+        uint32_t diagonal = std::min(dx, dy);
+        uint32_t straight = std::max(dx, dy) - diagonal;
+        return grid_.min_cost * (AStarSearch::kDiagonalStep * diagonal + AStarSearch::kStraightStep * straight);
+    };
+
+    auto greater_f = [](const Scratch::OpenNode& a, const Scratch::OpenNode& b)
+    { return a.f > b.f; };
+    scratch.records.clear();
+    scratch.open.clear();
+
+    auto relax = [&](uint32_t from, uint32_t to, uint32_t g)
+    {
+        auto [it, inserted] = scratch.records.try_emplace(to, Scratch::Record{g, from});
+        if (!inserted)
+        {
+            if (g >= it->second.g)
+            {
+                return;
+            }
+            it->second = {g, from};
+        }
+        scratch.open.push_back({g + heuristic(to), to});
+        std::push_heap(scratch.open.begin(), scratch.open.end(), greater_f);
+    };
+
+    scratch.records.emplace(kStartNode, Scratch::Record{0, kNoNode});
+    scratch.open.push_back({heuristic(kStartNode), kStartNode});
+
+    while (!scratch.open.empty())
+    {
+        std::pop_heap(scratch.open.begin(), scratch.open.end(), greater_f);
+        Scratch::OpenNode current = scratch.open.back();
+        scratch.open.pop_back();
+
+        const uint32_t id = current.node;
+        const uint32_t g = scratch.records[id].g;
+        if (current.f > g + heuristic(id))
+        {
+            continue;  // stale entry
+        }
+
+        if (id == kGoalNode)
+        {
+            scratch.abstract_path.clear();
+            for (uint32_t step = scratch.records[kGoalNode].parent; step != kStartNode; step = scratch.records[step].parent)
+            {
+                scratch.abstract_path.push_back(step);
+            }
+            std::reverse(scratch.abstract_path.begin(), scratch.abstract_path.end());
+            return true;
+        }
+
+        if (id == kStartNode)
+        {
+            for (auto [node, cost] : scratch.start_links)
+            {
+                relax(id, node, cost);
+            }
+            if (direct_cost != AStarSearch::kUnreachable)
+            {
+                relax(id, kGoalNode, direct_cost);
+            }
+            continue;
+        }
+
+        for (const Edge& edge : nodes_[id].edges)
+        {
+            relax(id, edge.to, g + edge.cost);
+        }
+        auto goal_link = scratch.goal_links.find(id);
+        if (goal_link != scratch.goal_links.end())
+        {
+            relax(id, kGoalNode, g + goal_link->second);
+        }
+    }
+
+    return false;
+}
+
+bool HierarchicalPathfinder::RefinePath(GridPoint start, GridPoint goal, Scratch& scratch, std::vector<GridPoint>& path) const
+{
+    path.clear();
+    GridPoint previous = start;
+    uint32_t previous_cluster = ClusterOf(start.x, start.y);
+
+    // Hops inside a cluster are refined with a cluster-bounded A*, hops
+    // between clusters are a single step across the border
+    auto walk_to = [&](GridPoint target, uint32_t cluster)
+    {
+        if (target == previous)
+        {
+            return true;
+        }
+        if (cluster != previous_cluster)
+        {
+            path.push_back(target);
+        }
+        else
+        {
+            if (!scratch.search.FindPath(grid_, previous, target, ClusterBounds(cluster), scratch.segment))
+            {
+                return false;
+            }
+            path.insert(path.end(), scratch.segment.begin(), scratch.segment.end());
+        }
+        previous = target;
+        previous_cluster = cluster;
+        return true;
+    };
+
+    for (uint32_t id : scratch.abstract_path)
+    {
+        if (!walk_to(nodes_[id].position, nodes_[id].cluster))
+        {
+            return false;
+        }
+    }
+    return walk_to(goal, ClusterOf(goal.x, goal.y));
+}
+
+bool HierarchicalPathfinder::LookupCache(uint64_t key, std::vector<GridPoint>& path) const
+{
+    std::lock_guard lock(cache_mutex_);
+    auto it = cache_index_.find(key);
+    if (it == cache_index_.end())
+    {
+        return false;
+    }
+    cache_.splice(cache_.begin(), cache_, it->second);
+    path = it->second->path;
+    return true;
+}
+
+void HierarchicalPathfinder::StoreCache(uint64_t key, const std::vector<GridPoint>& path, GridPoint start) const
+{
+    CacheEntry entry{key, path, {}};
+    entry.clusters.push_back(ClusterOf(start.x, start.y));
+    for (GridPoint point : path)
+    {
+        uint32_t cluster = ClusterOf(point.x, point.y);
+        if (cluster != entry.clusters.back())
+        {
+            entry.clusters.push_back(cluster);
+        }
+    }
+    std::sort(entry.clusters.begin(), entry.clusters.end());
+    entry.clusters.erase(std::unique(entry.clusters.begin(), entry.clusters.end()), entry.clusters.end());
+
+    std::lock_guard lock(cache_mutex_);
+    if (cache_index_.contains(key))
+    {
+        return;  // another thread got there first
+    }
+    cache_.push_front(std::move(entry));
+    cache_index_[key] = cache_.begin();
+    if (cache_.size() > kCacheCapacity)
+    {
+        cache_index_.erase(cache_.back().key);
+        cache_.pop_back();
+    }
+}
+
+void HierarchicalPathfinder::InvalidateCache(const std::vector<uint32_t>& dirty_clusters)
+{
+    std::lock_guard lock(cache_mutex_);
+    for (auto it = cache_.begin(); it != cache_.end();)
+    {
+        bool touches_dirty = std::any_of(it->clusters.begin(), it->clusters.end(), [&](uint32_t cluster)
+                                         { return std::binary_search(dirty_clusters.begin(), dirty_clusters.end(), cluster); });
+        if (touches_dirty)
+        {
+            cache_index_.erase(it->key);
+            it = cache_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+}  // namespace eerium
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "JobSystem.hpp"
+#include "Pathfinder.hpp"
+#include "TileMap.hpp"
+
+namespace eerium
+{
+
+/**
+ * HPA*-style pathfinding over a cluster-level abstract graph.
+ *
+ * The grid is split into square clusters. Every walkable stretch of a border
+ * between two clusters gets one or two transitions, each a pair of abstract
+ * nodes (one per side) joined by an inter-cluster edge; nodes of the same
+ * cluster are joined by intra-cluster edges holding the cost of the cheapest
+ * path that stays inside the cluster. Long queries search this small graph and
+ * then refine each hop with an A* limited to one cluster, short queries just
+ * run A* in a window around both ends.
+ *
+ * Tile changes repair only the borders and clusters they touch. Recent long
+ * paths are cached and dropped when a cluster they cross is repaired.
+ *
+ * FindPath() may be called from several threads at once; Build() and
+ * UpdateTiles() take an exclusive lock.
+ */
+class HierarchicalPathfinder
+{
+public:
+    static constexpr int kClusterSize = TileMap::kChunkSize;
+    static constexpr int kLongEntrance = 6;      // entrances this wide get a transition at each end
+    static constexpr size_t kCacheCapacity = 512;
+    static constexpr size_t kClustersPerJob = 4;
+
+    // Per-thread search state
+    struct Scratch
+    {
+        AStarSearch search;
+        std::vector<uint32_t> costs;
+        std::vector<GridPoint> segment;
+
+        struct Record
+        {
+            uint32_t g;
+            uint32_t parent;
+        };
+        std::unordered_map<uint32_t, Record> records;
+        struct OpenNode
+        {
+            uint32_t f;
+            uint32_t node;
+        };
+        std::vector<OpenNode> open;
+        std::vector<std::pair<uint32_t, uint32_t>> start_links;  // (node, cost from start)
+        std::unordered_map<uint32_t, uint32_t> goal_links;        // node -> cost to goal
+        std::vector<uint32_t> abstract_path;
+    };
+
+    // Rebuild everything from a full cost grid; clusters are processed in parallel when jobs is given
+    void Build(const CostGrid& grid, JobSystem* jobs = nullptr);
+
+    // Apply tile cost changes and repair the affected parts of the graph
+    void UpdateTiles(std::span<const TileCostChange> changes, JobSystem* jobs = nullptr);
+
+    /**
+     * @brief Find a path from start to goal
+     * @param path Receives the tiles after start, up to and including goal
+     * @return true if the goal is reachable
+     */
+    bool FindPath(GridPoint start, GridPoint goal, Scratch& scratch, std::vector<GridPoint>& path) const;
+
+    size_t GetNodeCount() const;
+
+    // Run fn with the current cost grid, holding off repairs until it returns
+    template <typename Fn>
+    void WithGrid(Fn&& fn) const
+    {
+        std::shared_lock lock(mutex_);
+        fn(grid_);
+    }
+
+private:
+    static constexpr uint32_t kNoNode = UINT32_MAX;
+
+    struct Edge
+    {
+        uint32_t to;
+        uint32_t cost;
+    };
+
+    struct Node
+    {
+        GridPoint position;
+        uint32_t cluster = 0;
+        bool alive = false;
+        std::vector<Edge> edges;
+    };
+
+    // Border between a cluster and its east (vertical) or south (horizontal) neighbor
+    struct Border
+    {
+        std::vector<uint32_t> nodes;
+    };
+
+    struct CacheEntry
+    {
+        uint64_t key;
+        std::vector<GridPoint> path;
+        std::vector<uint32_t> clusters;  // clusters the path passes through
+    };
+
+    uint32_t ClusterOf(int x, int y) const
+    {
+        return static_cast<uint32_t>(y / kClusterSize) * clusters_x_ + static_cast<uint32_t>(x / kClusterSize);
+    }
+    SearchBounds ClusterBounds(uint32_t cluster) const;
+    Border& VerticalBorder(int cx, int cy) { return vertical_borders_[static_cast<size_t>(cy) * (clusters_x_ - 1) + cx]; }
+    Border& HorizontalBorder(int cx, int cy) { return horizontal_borders_[static_cast<size_t>(cy) * clusters_x_ + cx]; }
+
+    uint32_t AddNode(GridPoint position);
+    void RemoveNode(uint32_t node);
+    void BuildBorder(int cx, int cy, bool vertical);
+    void ClearBorder(Border& border);
+    void BuildIntraEdges(uint32_t cluster, AStarSearch& search, std::vector<uint32_t>& costs);
+    void BuildIntraEdges(std::span<const uint32_t> clusters, JobSystem* jobs);
+
+    bool FindAbstractPath(GridPoint start, GridPoint goal, Scratch& scratch) const;
+    bool RefinePath(GridPoint start, GridPoint goal, Scratch& scratch, std::vector<GridPoint>& path) const;
+
+    bool LookupCache(uint64_t key, std::vector<GridPoint>& path) const;
+    void StoreCache(uint64_t key, const std::vector<GridPoint>& path, GridPoint start) const;
+    void InvalidateCache(const std::vector<uint32_t>& dirty_clusters);
+
+    mutable std::shared_mutex mutex_;
+    CostGrid grid_;
+    int clusters_x_ = 0;
+    int clusters_y_ = 0;
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> free_nodes_;
+    std::vector<std::vector<uint32_t>> cluster_nodes_;
+    std::vector<Border> vertical_borders_;
+    std::vector<Border> horizontal_borders_;
+
+    // LRU cache of long paths, guarded separately so readers can fill it
+    mutable std::mutex cache_mutex_;
+    mutable std::list<CacheEntry> cache_;
+    mutable std::unordered_map<uint64_t, std::list<CacheEntry>::iterator> cache_index_;
+};
+
+}  // namespace eerium
@@ -0,0 +1,235 @@
+#include "InputLog.hpp"
+
+#include <array>
+#include <fstream>
+#include <stdexcept>
+
+namespace eerium
+{
+
+namespace
+{
+
+constexpr std::array<char, 4> kMagic = {'E', 'R', 'I', 'L'};
+constexpr uint32_t kVersion = 1;
+
+enum class EventKind : uint8_t
+{
+    KEY_DOWN,
+    MOUSE_MOTION,
+    MOUSE_BUTTON_DOWN,
+    MOUSE_WHEEL,
+    WINDOW_RESIZED
+};
+
+template <typename T>
+void Write(std::ostream& out, T value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T Read(std::istream& in)
+{
+    T value{};
+    if (!in.read(reinterpret_cast<char*>(&value), sizeof(value)))
+    {
+        throw std::runtime_error("Input log is truncated");
+    }
+    return value;
+}
+
+// Ticks are mostly close together, so their deltas fit in one or two bytes
+void WriteVarint(std::ostream& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        Write<uint8_t>(out, static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    Write<uint8_t>(out, static_cast<uint8_t>(value));
+}
+
+uint64_t ReadVarint(std::istream& in)
+{
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        uint8_t byte = Read<uint8_t>(in);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return value;
+        }
+    }
+    throw std::runtime_error("Input log has a malformed tick");
+}
+
+}  // namespace
+
+InputLog::InputLog(uint32_t seed, int viewport_width, int viewport_height)
+    : seed_(seed), viewport_width_(viewport_width), viewport_height_(viewport_height)
+{
+}
+
+bool InputLog::IsRecorded(Uint32 event_type)
+{
+    switch (event_type)
+    {
+        case SDL_EVENT_KEY_DOWN:
+        case SDL_EVENT_MOUSE_MOTION:
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_WHEEL:
+        case SDL_EVENT_WINDOW_RESIZED:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void InputLog::Add(uint64_t tick, const SDL_Event& event)
+{
+    if (IsRecorded(event.type))
+    {
+        entries_.push_back({tick, event});
+    }
+}
+
+void InputLog::Save(const std::string& path) const
+{
+    std::ofstream out(path, std::ios::binary);
+    if (!out)
+    {
+        throw std::runtime_error("Failed to open input log for writing: " + path);
+    }
+
+    out.write(kMagic.data(), kMagic.size());
+    Write<uint32_t>(out, kVersion);
+    Write<uint32_t>(out, seed_);
+    Write<int32_t>(out, viewport_width_);
+    Write<int32_t>(out, viewport_height_);
+    Write<uint64_t>(out, tick_count_);
+    Write<uint64_t>(out, entries_.size());
+
+    uint64_t last_tick = 0;
+    for (const Entry& entry : entries_)
+    {
+        WriteVarint(out, entry.tick - last_tick);
+        last_tick = entry.tick;
+
+        const SDL_Event& event = entry.event;
+        switch (event.type)
+        {
+            case SDL_EVENT_KEY_DOWN:
+                Write(out, EventKind::KEY_DOWN);
+                Write<uint32_t>(out, event.key.key);
+                Write<uint16_t>(out, event.key.mod);
+                break;
+            case SDL_EVENT_MOUSE_MOTION:
+                Write(out, EventKind::MOUSE_MOTION);
+                Write<float>(out, event.motion.x);
+                Write<float>(out, event.motion.y);
+                break;
+            case SDL_EVENT_MOUSE_BUTTON_DOWN:
+                Write(out, EventKind::MOUSE_BUTTON_DOWN);
+                Write<uint8_t>(out, event.button.button);
+                Write<uint8_t>(out, event.button.clicks);
+                Write<float>(out, event.button.x);
+                Write<float>(out, event.button.y);
+                break;
+            case SDL_EVENT_MOUSE_WHEEL:
+                Write(out, EventKind::MOUSE_WHEEL);
+                Write<float>(out, event.wheel.x);
+                Write<float>(out, event.wheel.y);
+                Write<float>(out, event.wheel.mouse_x);
+                Write<float>(out, event.wheel.mouse_y);
+                break;
+            case SDL_EVENT_WINDOW_RESIZED:
+                Write(out, EventKind::WINDOW_RESIZED);
+                Write<int32_t>(out, event.window.data1);
+                Write<int32_t>(out, event.window.data2);
+                break;
+        }
+    }
+
+    if (!out)
+    {
+        throw std::runtime_error("Failed to write input log: " + path);
+    }
+}
+
+InputLog InputLog::Load(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        throw std::runtime_error("Failed to open input log: " + path);
+    }
+
+    std::array<char, 4> magic = {};
+    in.read(magic.data(), magic.size());
+    if (!in || magic != kMagic)
+    {
+        throw std::runtime_error("Not an input log: " + path);
+    }
+    if (Read<uint32_t>(in) != kVersion)
+    {
+        throw std::runtime_error("Unsupported input log version: " + path);
+    }
+
+    InputLog log;
+    log.seed_ = Read<uint32_t>(in);
+    log.viewport_width_ = Read<int32_t>(in);
+    log.viewport_height_ = Read<int32_t>(in);
+    log.tick_count_ = Read<uint64_t>(in);
+    const uint64_t entry_count = Read<uint64_t>(in);
+
+    uint64_t tick = 0;
+    for (uint64_t i = 0; i < entry_count; ++i)
+    {
+        tick += ReadVarint(in);
+
+        SDL_Event event;
+        SDL_zero(event);
+        switch (Read<EventKind>(in))
+        {
+            case EventKind::KEY_DOWN:
+                event.type = SDL_EVENT_KEY_DOWN;
+                event.key.key = Read<uint32_t>(in);
+                event.key.mod = Read<uint16_t>(in);
+                event.key.down = true;
+                break;
+            case EventKind::MOUSE_MOTION:
+                event.type = SDL_EVENT_MOUSE_MOTION;
+                event.motion.x = Read<float>(in);
+                event.motion.y = Read<float>(in);
+                break;
+            case EventKind::MOUSE_BUTTON_DOWN:
+                event.type = SDL_EVENT_MOUSE_BUTTON_DOWN;
+                event.button.button = Read<uint8_t>(in);
+                event.button.clicks = Read<uint8_t>(in);
+                event.button.x = Read<float>(in);
+                event.button.y = Read<float>(in);
+                event.button.down = true;
+                break;
+            case EventKind::MOUSE_WHEEL:
+                event.type = SDL_EVENT_MOUSE_WHEEL;
+                event.wheel.x = Read<float>(in);
+                event.wheel.y = Read<float>(in);
+                event.wheel.mouse_x = Read<float>(in);
+                event.wheel.mouse_y = Read<float>(in);
+                break;
+            case EventKind::WINDOW_RESIZED:
+                event.type = SDL_EVENT_WINDOW_RESIZED;
+                event.window.data1 = Read<int32_t>(in);
+                event.window.data2 = Read<int32_t>(in);
+                break;
+            default:
+                throw std::runtime_error("Input log has an unknown event: " + path);
+        }
+        log.entries_.push_back({tick, event});
+    }
+    return log;
+}
+
+}  // namespace eerium
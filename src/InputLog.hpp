@@ -0,0 +1,63 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace eerium
+{
+
+/**
+ * Seed and input of one play session, for repeatable runs.
+ *
+ * Every recorded event is tagged with the fixed update tick it was handled
+ * before. Feeding the events back through the event router in front of the
+ * same ticks, on a map generated from the same seed, reproduces the session.
+ *
+ * The file is a small header followed by one record per event: the tick as a
+ * varint delta to the previous record, the event kind and only the fields the
+ * game reads. Values are stored in host byte order.
+ */
+class InputLog
+{
+public:
+    struct Entry
+    {
+        uint64_t tick;
+        SDL_Event event;
+    };
+
+    InputLog() = default;
+    InputLog(uint32_t seed, int viewport_width, int viewport_height);
+
+    // Whether events of this type end up in the log; everything else is ignored by Add()
+    static bool IsRecorded(Uint32 event_type);
+
+    void Add(uint64_t tick, const SDL_Event& event);
+
+    uint32_t GetSeed() const { return seed_; }
+    int GetViewportWidth() const { return viewport_width_; }
+    int GetViewportHeight() const { return viewport_height_; }
+
+    // Number of fixed updates the session ran for
+    uint64_t GetTickCount() const { return tick_count_; }
+    void SetTickCount(uint64_t tick_count) { tick_count_ = tick_count; }
+
+    // Sorted by tick, in the order the events were handled
+    const std::vector<Entry>& GetEntries() const { return entries_; }
+
+    // Both throw std::runtime_error when the file cannot be written or read
+    void Save(const std::string& path) const;
+    static InputLog Load(const std::string& path);
+
+private:
+    uint32_t seed_ = 0;
+    int viewport_width_ = 0;
+    int viewport_height_ = 0;
+    uint64_t tick_count_ = 0;
+    std::vector<Entry> entries_;
+};
+
+}  // namespace eerium
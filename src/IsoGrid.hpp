@@ -1,12 +1,39 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
+#include "CameraTransform.hpp"
+#include "DepthBuckets.hpp"
+#include "EntityStore.hpp"
+#include "FieldOfView.hpp"
+#include "FlowField.hpp"
+#include "JobSystem.hpp"
+#include "Minimap.hpp"
+#include "ParticleSystem.hpp"
+#include "Pathfinder.hpp"
+#include "PickBuffer.hpp"
 #include "SDL3_image/SDL_image.h"
+#include "SpatialHash.hpp"
+#include "SpriteAnimation.hpp"
+#include "TerrainMesh.hpp"
+#include "TileTexture.hpp"
 #include "sdl/Color.hpp"
+#include "sdl/CommandBuffer.hpp"
+#include "sdl/RenderTarget.hpp"
 #include "sdl/Renderer.hpp"
+#include "TileMap.hpp"
 
 namespace eerium
 {
@@ -22,12 +49,65 @@ public:
     static constexpr float kTileAspectRatio = 0.45f;   // slightly flatter, not 2:1
     static constexpr int kMapWidth = 33;
     static constexpr int kMapHeight = 33;
+    static constexpr int kDiagonalCount = kMapWidth + kMapHeight - 1;  // iso diagonals, col + row
+
+    // Heights in tile heights; ground rises by one step per elevation level
+    static constexpr float kElevationStep = 0.25f;
+    static constexpr float kWallHeight = 1.0f;
+    static constexpr int kHillSpacing = 8;  // tiles between elevation samples
+
+    // The terrain cache extends this far past every window edge, so small scrolls reuse it
+    static constexpr float kTerrainCacheMargin = 256.0f;
+
+    // At or below this tile width the ground is drawn a chunk at a time, see RecordChunkLod()
+    static constexpr float kLodTileWidth = 48.0f;
+
+    // Map painting, brushes are picked with the number keys
+    enum class Brush : uint8_t
+    {
+        NONE,
+        GRASS,
+        DIRT,
+        WALL
+    };
+    static constexpr int kBrushRadius = 1;  // tiles painted around the cursor
 
     // Camera deadzone - the screen is divided into this many parts, camera follows when player leaves center area
     static constexpr float kCameraDeadzoneDivisor = 5.0f;
 
     static constexpr sdl::Color kHoverColor = {255u, 255u, 255u, 100u};
 
+    // Wandering NPCs, moved in batch by the entity store
+    static constexpr int kNpcCount = 24;
+    static constexpr float kNpcSpeed = 3.0f;           // tiles per second
+    static constexpr int kNpcWanderRadius = 4;         // max tiles per wander step
+    static constexpr int kNpcWanderChance = 50;        // 1 in N ticks an idle NPC picks a new target
+    static constexpr size_t kNpcBatchSize = 4096;      // movers per parallel update chunk
+    static constexpr float kNpcRadius = 0.5f;          // blocks the player, picked by the cursor
+
+    // Line of sight, in tiles
+    static constexpr int kPlayerSightRadius = 10;
+    static constexpr int kNpcSightRadius = 6;
+    static constexpr sdl::Color kFogColor = {0u, 0u, 0u, 140u};
+
+    // Animated units, as wide as this fraction of a tile; slot 0 is the player, NPCs follow by EntityId
+    static constexpr float kUnitWidth = 0.4f;
+    static constexpr size_t kPlayerAnimation = 0;
+    static constexpr size_t kFirstNpcAnimation = 1;
+
+    // Particle effects: rain toggled with R, dust behind the player, a burst on the rally point
+    static constexpr float kRainPerSecond = 4000.0f;
+    static constexpr float kRainHeight = 8.0f;  // tile heights above the ground
+    static constexpr float kDustPerSecond = 40.0f;
+    static constexpr int kRallyBurstCount = 240;
+
+    // Minimap in the top right corner, toggled with M
+    static constexpr float kMinimapWidth = 200.0f;
+    static constexpr float kMinimapMargin = 10.0f;
+
+    // Ids in the pick buffer: tiles are 1 + their index, entities start at kEntityPickBase
+    static constexpr PickId kEntityPickBase = 0x800000;
+
     // Static helper functions for isometric coordinate transformations
     struct TileCoord
     {
@@ -44,20 +124,16 @@ public:
     // Convert tile coordinates to pixel coordinates
     PixelCoord TileToPixel(const TileCoord& tile) const
     {
-        return {
-            (tile.x - tile.y) * (tile_width_ / 2.0f) + offset_.x,
-            (tile.x + tile.y) * (tile_height_ / 2.0f) + offset_.y};
+        PixelCoord result;
+        camera_.TileToPixel(tile.x, tile.y, result.x, result.y);
+        return result;
     }
 
     // Convert pixel coordinates to tile coordinates
     TileCoord PixelToTile(const PixelCoord& pixel, bool round = false) const
     {
-        float adjusted_x = pixel.x - offset_.x;
-        float adjusted_y = pixel.y - offset_.y;
-
-        TileCoord result = {
-            (adjusted_x / (tile_width_ / 2.0f) + adjusted_y / (tile_height_ / 2.0f)) / 2.0f,
-            (adjusted_y / (tile_height_ / 2.0f) - adjusted_x / (tile_width_ / 2.0f)) / 2.0f};
+        TileCoord result;
+        camera_.PixelToTile(pixel.x, pixel.y, result.x, result.y);
         if (round)
         {
             result.x = std::round(result.x);
@@ -74,7 +150,20 @@ public:
 
     TileCoord PixelToTile(float pixelX, float pixelY, bool round = false) const
     {
-        return PixelToTile({pixelX, pixelY});
+        return PixelToTile({pixelX, pixelY}, round);
+    }
+
+    // Batch versions for tight loops (rendering, picking), see CameraTransform
+    void TileToPixel(std::span<const float> tile_x, std::span<const float> tile_y,
+                     std::span<float> pixel_x, std::span<float> pixel_y) const
+    {
+        camera_.TileToPixel(tile_x, tile_y, pixel_x, pixel_y);
+    }
+
+    void PixelToTile(std::span<const float> pixel_x, std::span<const float> pixel_y,
+                     std::span<float> tile_x, std::span<float> tile_y, bool round = false) const
+    {
+        camera_.PixelToTile(pixel_x, pixel_y, tile_x, tile_y, round);
     }
 
     class Player
@@ -92,41 +181,42 @@ public:
         {
             position_ = original_position;
             target_position_ = original_position;
+            path_.clear();
+            path_step_ = 0;
         }
 
         void Update()
         {
+            // Walk the path one waypoint at a time
+            if (path_step_ < path_.size() && position_.x == target_position_.x && position_.y == target_position_.y)
+            {
+                target_position_ = path_[path_step_++];
+            }
+
             // Smooth movement towards target position
             static constexpr float kMovementSpeed = 20.0f;  // units per second
-            static constexpr float kMinDistance = 0.01f;   // stop when very close
             static constexpr float kUpdateTime = 1.0f / 100.0f;
             static constexpr float kMoveDistance = kMovementSpeed * kUpdateTime;
 
-            float dx = target_position_.x - position_.x;
-            float dy = target_position_.y - position_.y;
-            // Calculate distance to target
-            float distance = std::sqrt(dx * dx + dy * dy);
-            if (distance > kMinDistance)
-            {
-                // Normalize direction and apply speed
-                float normalized_dx = dx / distance;
-                float normalized_dy = dy / distance;
+            // Same step as the batched EntityStore::Update(), for a single mover
+            MoveTowards(position_.x, position_.y, target_position_.x, target_position_.y, kMoveDistance);
+        }
 
-                // Don't overshoot the target
-                if (kMoveDistance > distance)
-                {
-                    position_ = target_position_;
-                }
-                else
-                {
-                    position_.x += normalized_dx * kMoveDistance;
-                    position_.y += normalized_dy * kMoveDistance;
-                }
+        // Follow a list of waypoints, replacing any previous path or target
+        void SetPath(std::vector<TileCoord> path)
+        {
+            path_ = std::move(path);
+            path_step_ = 0;
+            if (!path_.empty())
+            {
+                target_position_ = path_[path_step_++];
             }
         }
 
         void MoveBy(float dx, float dy)
         {
+            path_.clear();
+            path_step_ = 0;
             target_position_.x += dx;
             target_position_.y += dy;
         }
@@ -146,6 +236,17 @@ public:
         }
 
         TileCoord GetPosition() const { return position_; }
+        TileCoord GetTargetPosition() const { return target_position_; }
+
+        // Waypoints not passed yet, starting with the one being walked to
+        std::span<const TileCoord> GetRemainingPath() const
+        {
+            return std::span(path_).subspan(path_step_ > 0 ? path_step_ - 1 : 0);
+        }
+        bool IsMoving() const
+        {
+            return position_.x != target_position_.x || position_.y != target_position_.y || path_step_ < path_.size();
+        }
         sdl::Color GetColor() const { return color_; }
         std::string GetName() const { return name_; }
 
@@ -153,20 +254,13 @@ public:
         std::string name_;
         TileCoord position_;
         TileCoord target_position_;
+        std::vector<TileCoord> path_;
+        size_t path_step_ = 0;
         sdl::Color color_;
     };
 
-    enum class Material
-    {
-        GRASS,
-        DIRT,
-        STONE
-    };
-
-    struct Tile
-    {
-        Material material = Material::GRASS;
-    };
+    using Material = eerium::Material;
+    using Tile = eerium::Tile;
 
     static constexpr sdl::Color MaterialToColor(Material material)
     {
@@ -183,6 +277,18 @@ public:
         }
     }
 
+    // Minimap pixel of a tile: its material, lighter on hills, darker under walls
+    static constexpr sdl::Color MinimapColor(const Tile& tile)
+    {
+        sdl::Color color = MaterialToColor(tile.material);
+        int light = 80 + 20 * tile.elevation - (tile.object != TileObject::NONE ? 30 : 0);
+        auto shade = [light](Uint8 channel)
+        {
+            return static_cast<Uint8>(std::min(255, channel * light / 100));
+        };
+        return {shade(color.r), shade(color.g), shade(color.b), 255};
+    }
+
     SDL_Texture* MaterialToTexture(Material material)
     {
         switch (material)
@@ -209,6 +315,7 @@ public:
         new_width = std::max(kMinTileWidth, std::min(kMaxTileWidth, new_width));
         tile_width_ = new_width;
         tile_height_ = tile_width_ * kTileAspectRatio;
+        UpdateCamera();
     }
 
     void ZoomIn(float factor = 1.1f)
@@ -217,6 +324,16 @@ public:
         new_width = std::min(kMaxTileWidth, new_width);
         tile_width_ = new_width;
         tile_height_ = tile_width_ * kTileAspectRatio;
+        UpdateCamera();
+    }
+
+    // Center the view on a tile position at a zoom factor, for scripted camera moves
+    void LookAt(float tile_x, float tile_y, float zoom_factor)
+    {
+        SetZoom(zoom_factor);
+        offset_.x = viewport_.width / 2.0f - (tile_x - tile_y) * tile_width_ / 2.0f;
+        offset_.y = viewport_.height / 2.0f - (tile_x + tile_y) * tile_height_ / 2.0f;
+        UpdateCamera();
     }
 
     void ZoomOut(float factor = 0.9f)
@@ -225,15 +342,52 @@ public:
         new_width = std::max(kMinTileWidth, new_width);
         tile_width_ = new_width;
         tile_height_ = tile_width_ * kTileAspectRatio;
+        UpdateCamera();
     }
 
-    IsoGrid()
+    explicit IsoGrid(JobSystem& jobs) : jobs_(jobs), pathfinder_(jobs)
     {
-        Reset();
+        // Decode the tile textures on the job system; Render() uploads them once they are needed
+        for (size_t i = 0; i < kTextureFiles.size(); ++i)
+        {
+            texture_jobs_[i] = jobs_.Schedule([this, i]
+                                              { decoded_textures_[i] = IMG_Load(kTextureFiles[i].path); });
+        }
+
+        // Tile centers never move, keep them around for batch transforms
+        tile_center_x_.reserve(kMapWidth * kMapHeight);
+        tile_center_y_.reserve(kMapWidth * kMapHeight);
+        for (int row = 0; row < kMapHeight; ++row)
+        {
+            for (int col = 0; col < kMapWidth; ++col)
+            {
+                tile_center_x_.push_back(static_cast<float>(col));
+                tile_center_y_.push_back(static_cast<float>(row));
+            }
+        }
+        tile_screen_x_.resize(tile_center_x_.size());
+        tile_screen_y_.resize(tile_center_y_.size());
+        terrain_dirty_chunks_.Resize(map_.GetChunkCount());
+
+        // Frames of the unit sheet, see CreateUnitSheet()
+        idle_clip_ = animator_.AddClip({0, 2, 0.5f, true});
+        walk_clip_ = animator_.AddClip({2, 4, 0.12f, true});
+
+        UpdateCamera();
+        Reset(std::random_device{}());
     }
 
     ~IsoGrid()
     {
+        jobs_.Wait(texture_jobs_);
+        for (SDL_Surface* surface : decoded_textures_)
+        {
+            if (surface)
+            {
+                SDL_DestroySurface(surface);
+            }
+        }
+
         if (grass_texture_)
         {
             SDL_DestroyTexture(grass_texture_);
@@ -248,250 +402,1854 @@ public:
         }
     }
 
-    void Reset()
+    // Start over on a map generated from seed; the same seed always gives the same session
+    void Reset(uint32_t seed)
     {
-        // Make a simple map
-        for (int r = 0; r < kMapHeight; ++r)
+        seed_ = seed;
+        rng_.seed(seed);
+
+        // Make a simple map, one row of chunks per job. Every row has its own
+        // generator, so the result does not depend on which thread made it.
+        jobs_.ParallelFor(map_.GetChunksY(), 1, [this, seed](size_t begin, size_t end)
+                          {
+                              for (size_t chunk_row = begin; chunk_row < end; ++chunk_row)
+                              {
+                                  GenerateChunkRow(static_cast<int>(chunk_row), seed);
+                              }
+                          });
+
+        // Reset player, on walkable ground
+        map_.At(kMapWidth / 2, kMapHeight / 2).material = Material::GRASS;
+        map_.At(kMapWidth / 2, kMapHeight / 2).object = TileObject::NONE;
+        RebuildObjectList();
+
+        // The whole map is new, edits made before are obsolete
+        map_.TakeChanges(tile_changes_, terrain_dirty_chunks_);
+        terrain_dirty_chunks_.Clear();
+        player_.Reset({kMapWidth / 2, kMapHeight / 2});
+        offset_ = kDefaultOffset;
+        tile_width_ = kDefaultTileWidth;
+        tile_height_ = kDefaultTileWidth * kTileAspectRatio;
+        UpdateCamera();
+        player_path_request_ = kNoPathRequest;
+        rally_request_ = kNoPathRequest;
+        rally_field_.reset();
+        rally_field_stale_ = false;
+        pathfinder_.SetGrid(CostGrid::FromTileMap(map_));
+
+        // Scatter NPCs over the map
+        entities_.Clear();
+        entities_.Reserve(kNpcCount);
+        for (int i = 0; i < kNpcCount; ++i)
+        {
+            sdl::Color color = {static_cast<Uint8>(80 + rng_() % 176), static_cast<Uint8>(80 + rng_() % 176), 255u, 200u};
+            entities_.Create(static_cast<float>(rng_() % kMapWidth), static_cast<float>(rng_() % kMapHeight), kNpcSpeed, color);
+        }
+        npc_hash_.Clear();
+        npc_hash_.Sync(entities_);
+
+        // Everyone starts idle, out of step with each other
+        const auto& npc_ids = entities_.GetIds();
+        EntityId max_id = npc_ids.empty() ? 0 : *std::max_element(npc_ids.begin(), npc_ids.end());
+        animator_.Resize(kFirstNpcAnimation + max_id + 1);
+        for (size_t slot = 0; slot < animator_.Size(); ++slot)
+        {
+            animator_.Start(slot, idle_clip_, static_cast<float>(slot % 7) * 0.13f);
+        }
+
+        // One viewer for the player and one per NPC, indexed by EntityId
+        fov_.Clear();
+        fov_.SetMap(map_);
+        GridPoint player_tile = PlayerTile();
+        player_viewer_ = fov_.AddViewer(player_tile.x, player_tile.y, kPlayerSightRadius);
+        npc_viewers_.clear();
+        const auto& ids = entities_.GetIds();
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            npc_viewers_.resize(std::max<size_t>(npc_viewers_.size(), ids[i] + 1));
+            npc_viewers_[ids[i]] = fov_.AddViewer(static_cast<int>(std::round(entities_.PositionsX()[i])),
+                                                  static_cast<int>(std::round(entities_.PositionsY()[i])), kNpcSightRadius);
+        }
+        fov_.Update(&jobs_);
+        terrain_dirty_ = true;
+        terrain_meshes_dirty_ = true;
+        particles_.Clear();
+        particles_.Random().seed(seed);
+
+        for (int row = 0; row < kMapHeight; ++row)
+        {
+            for (int col = 0; col < kMapWidth; ++col)
+            {
+                minimap_.SetTile(col, row, MinimapColor(map_.At(col, row)));
+            }
+        }
+    }
+
+    uint32_t GetSeed() const { return seed_; }
+
+    // Size of the area the camera keeps the player in, normally the window size
+    void SetViewportSize(float width, float height)
+    {
+        viewport_ = {width, height};
+    }
+
+    /**
+     * Solve path requests before the update that follows them, instead of
+     * whenever a worker gets to them. Costs some latency, but makes a session
+     * replayed from an input log play out exactly like the recorded one.
+     */
+    void SetDeterministic(bool deterministic) { deterministic_ = deterministic; }
+
+    // FNV-1a over the map and every position, to compare the end states of two runs
+    uint64_t GetStateHash() const
+    {
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](uint32_t value)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                hash = (hash ^ ((value >> (i * 8)) & 0xFF)) * 1099511628211ull;
+            }
+        };
+        for (const Tile& tile : map_.GetTiles())
+        {
+            mix(static_cast<uint32_t>(tile.material) | (static_cast<uint32_t>(tile.elevation) << 8) |
+                (static_cast<uint32_t>(tile.object) << 16));
+        }
+        mix(std::bit_cast<uint32_t>(player_.GetPosition().x));
+        mix(std::bit_cast<uint32_t>(player_.GetPosition().y));
+        for (size_t i = 0; i < entities_.Size(); ++i)
+        {
+            mix(std::bit_cast<uint32_t>(entities_.PositionsX()[i]));
+            mix(std::bit_cast<uint32_t>(entities_.PositionsY()[i]));
+        }
+        return hash;
+    }
+
+    // Rolling hills: random heights on a coarse lattice, blended in between.
+    // Only depends on the position, so chunk rows can be generated in any order.
+    static uint8_t ElevationAt(int x, int y, unsigned seed)
+    {
+        auto lattice = [seed](int lx, int ly)
+        {
+            uint32_t h = seed ^ (static_cast<uint32_t>(lx) * 0x8DA6B343u) ^ (static_cast<uint32_t>(ly) * 0xD8163841u);
+            h = (h ^ (h >> 15)) * 0x2C1B3C6Du;
+            h ^= h >> 12;
+            return static_cast<float>(h % (Tile::kMaxElevation + 1));
+        };
+        const int lx = x / kHillSpacing;
+        const int ly = y / kHillSpacing;
+        const float fx = static_cast<float>(x % kHillSpacing) / kHillSpacing;
+        const float fy = static_cast<float>(y % kHillSpacing) / kHillSpacing;
+        const float top = lattice(lx, ly) + (lattice(lx + 1, ly) - lattice(lx, ly)) * fx;
+        const float bottom = lattice(lx, ly + 1) + (lattice(lx + 1, ly + 1) - lattice(lx, ly + 1)) * fx;
+        return static_cast<uint8_t>(std::round(top + (bottom - top) * fy));
+    }
+
+    void GenerateChunkRow(int chunk_row, unsigned seed)
+    {
+        std::minstd_rand rng(seed ^ (static_cast<unsigned>(chunk_row) * 0x9E3779B9u));
+        int first_row = chunk_row * TileMap::kChunkSize;
+        int last_row = std::min(first_row + TileMap::kChunkSize, kMapHeight);
+        for (int r = first_row; r < last_row; ++r)
         {
             for (int c = 0; c < kMapWidth; ++c)
             {
-                Tile& tile = map_[r][c];
+                Tile& tile = map_.At(c, r);
                 tile.material = Material::GRASS;
-                if (rand() % 8 == 0)
+                tile.object = TileObject::NONE;
+                if (rng() % 8 == 0)
                 {
                     tile.material = Material::DIRT;
                 }
-                else if (rand() % 7 == 0)
+                else if (rng() % 7 == 0)
                 {
+                    // Stone is walled off
                     tile.material = Material::STONE;
+                    tile.object = TileObject::WALL;
                 }
+                tile.elevation = ElevationAt(c, r, seed);
             }
         }
-
-        // Reset player
-        player_.Reset({kMapWidth / 2, kMapHeight / 2});
     }
 
-    void Update()
+    void Update(float dt)
     {
-        player_.Update();
-    }
+        if (deterministic_)
+        {
+            pathfinder_.WaitAll();
+        }
 
-    void HandleEvent(const SDL_Event& event)
-    {
-        if (event.type == SDL_EVENT_KEY_DOWN)
+        ApplyTileChanges();
+
+        // Only the frame jobs below touch the animation slots of the NPCs
+        animator_.Update(dt);
+
+        // Pick up paths solved by the worker threads since the last update
+        path_results_.clear();
+        pathfinder_.Poll(path_results_);
+        for (PathResult& result : path_results_)
         {
-            switch (event.key.key)
+            if (result.id == player_path_request_)
             {
-                case SDLK_UP:
-                    player_.MoveBy(-1, -1);
-                    break;
-                case SDLK_DOWN:
-                    player_.MoveBy(1, 1);
-                    break;
-                case SDLK_LEFT:
-                    player_.MoveBy(-1, 1);
-                    break;
-                case SDLK_RIGHT:
-                    player_.MoveBy(1, -1);
-                    break;
+                player_path_request_ = kNoPathRequest;
+                if (result.found)
+                {
+                    std::vector<TileCoord> waypoints;
+                    waypoints.reserve(result.path.size());
+                    for (GridPoint point : result.path)
+                    {
+                        waypoints.push_back({static_cast<float>(point.x), static_cast<float>(point.y)});
+                    }
+                    player_.SetPath(std::move(waypoints));
+                }
             }
         }
 
-        if (event.type == SDL_EVENT_MOUSE_BUTTON_DOWN)
+        field_results_.clear();
+        pathfinder_.Poll(field_results_);
+        for (FlowFieldResult& result : field_results_)
         {
-            if (event.button.button == SDL_BUTTON_LEFT)
+            if (result.id == rally_request_)
             {
-                // Convert mouse position to tile coordinates using helper function
-                TileCoord tilePos = PixelToTile(event.button.x, event.button.y);
-                player_.MoveTo(tilePos.x, tilePos.y, true);
+                rally_request_ = kNoPathRequest;
+                rally_field_ = std::move(result.field);
             }
         }
 
-        if (event.type == SDL_EVENT_MOUSE_MOTION)
+        // NPCs move on the job system while the player is updated here; the
+        // game loop syncs the frame jobs before anything reads the positions
+        auto move_npcs = [this, dt]
         {
-            mouse_position_.x = event.motion.x;
-            mouse_position_.y = event.motion.y;
-            mouse_position_valid_ = true;
-        }
+            jobs_.ParallelFor(entities_.Size(), kNpcBatchSize, [this, dt](size_t begin, size_t end)
+                              { entities_.UpdateRange(begin, end, dt); });
 
-        if (event.type == SDL_EVENT_MOUSE_WHEEL)
+            const auto& ids = entities_.GetIds();
+            for (size_t i = 0; i < ids.size(); ++i)
+            {
+                animator_.Play(kFirstNpcAnimation + ids[i], entities_.HasArrived(i) ? idle_clip_ : walk_clip_);
+            }
+        };
+        // Sight only changes for viewers that stepped onto another tile
+        GridPoint player_tile = PlayerTile();
+        fov_.MoveViewer(player_viewer_, player_tile.x, player_tile.y);
+        auto update_sight = [this]
         {
-            // Zoom in/out based on wheel direction
-            if (event.wheel.y > 0)
+            const auto& ids = entities_.GetIds();
+            for (size_t i = 0; i < ids.size(); ++i)
             {
-                ZoomIn();  // Scroll up = zoom in
+                fov_.MoveViewer(npc_viewers_[ids[i]], static_cast<int>(std::round(entities_.PositionsX()[i])),
+                                static_cast<int>(std::round(entities_.PositionsY()[i])));
             }
-            else if (event.wheel.y < 0)
+            fov_.Update(&jobs_);
+        };
+        auto retarget_npcs = [this, player_tile]
+        {
+            if (rally_field_)
             {
-                ZoomOut();  // Scroll down = zoom out
+                SteerNpcs();
+            }
+            else
+            {
+                WanderNpcs(player_tile);
             }
-        }
-    }
-
-    void OffsetMove(float dx, float dy)
-    {
-        offset_.x += dx;
-        offset_.y += dy;
-    }
-
-    void DrawTile(sdl::Renderer& renderer, const TileCoord& position, sdl::Color color)
-    {
-        PixelCoord pixel_pos = TileToPixel(position);
-        float screen_x = pixel_pos.x;
-        float screen_y = pixel_pos.y;
-
-        SDL_FColor fcolor = {color.r / 255.0f, color.g / 255.0f,
-                             color.b / 255.0f, color.a / 255.0f};
-
-        // Diamond vertices with color data
-        SDL_Vertex diamond[4] = {
-            {{screen_x, (screen_y - tile_height_ / 2.0f)}, fcolor, {0.0f, 0.0f}},  // top
-            {{(screen_x + tile_width_ / 2.0f), screen_y}, fcolor, {0.0f, 0.0f}},   // right
-            {{screen_x, (screen_y + tile_height_ / 2.0f)}, fcolor, {0.0f, 0.0f}},  // bottom
-            {{(screen_x - tile_width_ / 2.0f), screen_y}, fcolor, {0.0f, 0.0f}}    // left
         };
+        JobHandle moved = jobs_.ScheduleFrameJob(move_npcs);
+        JobHandle sighted = jobs_.ScheduleFrameJob(update_sight, std::span(&moved, 1));
+        jobs_.ScheduleFrameJob(retarget_npcs, std::span(&sighted, 1));
+        jobs_.ScheduleFrameJob([this]
+                               { npc_hash_.Sync(entities_); },
+                               std::span(&moved, 1));
 
-        // Indices for 2 triangles making a diamond
-        int indices[] = {0, 1, 2, 0, 2, 3};
-        SDL_RenderGeometry(renderer, nullptr, diamond, 4, indices, 6);
-    }
-
-    void DrawTile(sdl::Renderer& renderer, const TileCoord& position, SDL_Texture* texture)
-    {
-        PixelCoord pixel_pos = TileToPixel(position);
-        float screen_x = pixel_pos.x;
-        float screen_y = pixel_pos.y;
-
-        SDL_FRect dest = {
-            (float)(screen_x - tile_width_ / 2),  // center diamond
-            (float)(screen_y - tile_height_ / 2),
-            (float)tile_width_,
-            (float)tile_height_};
+        EmitParticles(dt);
+        jobs_.ScheduleFrameJob([this, dt]
+                               { particles_.Update(dt); });
 
-        SDL_RenderTexture(renderer, texture, nullptr, &dest);
+        player_.Update();
+        animator_.Play(kPlayerAnimation, player_.IsMoving() ? walk_clip_ : idle_clip_);
+        UpdateCameraBounds();
     }
 
-    void UpdateCameraBounds(sdl::Renderer& renderer)
+    /**
+     * Forward the tile edits since the last update to everything derived from
+     * the map, once per tick however many tiles were painted: the path graph
+     * and the field of view are repaired around the changed tiles, the terrain
+     * meshes of the changed chunks are rebuilt on the next render. Paths that
+     * were solved on the old costs are asked for again; the rally field only
+     * once the painting pauses, as it covers the whole map.
+     */
+    void ApplyTileChanges()
     {
-        // Update window size for camera system
-        auto window_size = renderer.GetWindowSize();
-
-        // Camera following logic - keep player in center area
-        PixelCoord player_screen_pos = TileToPixel(player_.GetPosition());
-
-        // Calculate center area boundaries using the deadzone divisor
-        // For divisor=5: center area is middle 1/5 of screen, camera follows in outer 4/5
-        float margin_size = window_size.width / kCameraDeadzoneDivisor;
-        float center_left_bound = (window_size.width - margin_size) / 2.0f;
-        float center_right_bound = (window_size.width + margin_size) / 2.0f;
-
-        float margin_size_y = window_size.height / kCameraDeadzoneDivisor;
-        float center_top_bound = (window_size.height - margin_size_y) / 2.0f;
-        float center_bottom_bound = (window_size.height + margin_size_y) / 2.0f;
-
-        // Check if player is outside center area and adjust camera
-        bool needs_camera_update = false;
-        PixelCoord new_offset = offset_;
+        if (!map_.HasChanges())
+        {
+            if (rally_field_stale_ && rally_field_)
+            {
+                rally_request_ = pathfinder_.RequestFlowField(rally_field_->GetTarget());
+            }
+            rally_field_stale_ = false;
+            return;
+        }
+        map_.TakeChanges(tile_changes_, terrain_dirty_chunks_);
 
-        if (player_screen_pos.x < center_left_bound)
+        cost_changes_.clear();
+        bool objects_changed = false;
+        for (const TileChange& change : tile_changes_)
         {
-            new_offset.x = offset_.x + (center_left_bound - player_screen_pos.x);
-            needs_camera_update = true;
+            uint8_t cost = TileMoveCost(change.after);
+            if (cost != TileMoveCost(change.before))
+            {
+                cost_changes_.push_back({{change.x, change.y}, cost});
+            }
+            fov_.SetOpaque(change.x, change.y, TileBlocksSight(change.after));
+            minimap_.SetTile(change.x, change.y, MinimapColor(change.after));
+            objects_changed |= change.before.object != change.after.object;
         }
-        else if (player_screen_pos.x > center_right_bound)
+        if (!cost_changes_.empty())
         {
-            new_offset.x = offset_.x + (center_right_bound - player_screen_pos.x);
-            needs_camera_update = true;
+            pathfinder_.UpdateTiles(cost_changes_);
+            RepathAround(cost_changes_);
         }
-
-        if (player_screen_pos.y < center_top_bound)
+        if (objects_changed)
         {
-            new_offset.y = offset_.y + (center_top_bound - player_screen_pos.y);
-            needs_camera_update = true;
+            RebuildObjectList();
         }
-        else if (player_screen_pos.y > center_bottom_bound)
+    }
+
+    // Ask again for the player's path if it crosses a changed tile, stopping
+    // after the current step meanwhile. The rally field is marked stale if a
+    // change can alter it; the old field keeps steering until the new one arrives.
+    void RepathAround(std::span<const TileCostChange> changes)
+    {
+        std::span<const TileCoord> path = player_.GetRemainingPath();
+        auto on_path = [&](const TileCostChange& change)
         {
-            new_offset.y = offset_.y + (center_bottom_bound - player_screen_pos.y);
-            needs_camera_update = true;
+            return std::any_of(path.begin(), path.end(), [&](const TileCoord& waypoint)
+                               { return static_cast<int>(waypoint.x) == change.tile.x &&
+                                        static_cast<int>(waypoint.y) == change.tile.y; });
+        };
+        if (!path.empty() && std::any_of(changes.begin(), changes.end(), on_path))
+        {
+            GridPoint goal = {static_cast<int>(path.back().x), static_cast<int>(path.back().y)};
+            player_.SetPath({});
+            player_path_request_ = pathfinder_.Request(PlayerTile(), goal);
         }
 
-        if (needs_camera_update)
+        if (rally_field_ && std::any_of(changes.begin(), changes.end(), [this](const TileCostChange& change)
+                                        { return CanAlterRallyField(change.tile); }))
         {
-            offset_ = new_offset;
-            // mouse_position_valid_ = false;
+            rally_field_stale_ = true;
         }
     }
 
-    void Render(sdl::Renderer& renderer)
+    // Whether a cost change on a tile can alter the rally field: only if the
+    // tile or a neighbour reaches the rally point, as opening a tile next to a
+    // route may shorten it; tiles cut off from the point change nothing
+    bool CanAlterRallyField(GridPoint tile) const
     {
-        if (grass_texture_ == nullptr)
+        for (int dy = -1; dy <= 1; ++dy)
         {
-            // Load textures if not already done
-            grass_texture_ = IMG_LoadTexture(renderer, "../resources/textures/grass.png");
-            if (!grass_texture_)
+            for (int dx = -1; dx <= 1; ++dx)
             {
-                throw std::runtime_error("Failed to load grass texture");
+                if (rally_field_->InBounds(tile.x + dx, tile.y + dy) &&
+                    rally_field_->GetCost(tile.x + dx, tile.y + dy) != AStarSearch::kUnreachable)
+                {
+                    return true;
+                }
             }
         }
-        if (dirt_texture_ == nullptr)
+        return false;
+    }
+
+    // Spawn the particles of the continuous effects for one update
+    void EmitParticles(float dt)
+    {
+        std::minstd_rand& random = particles_.Random();
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        if (raining_)
         {
-            dirt_texture_ = IMG_LoadTexture(renderer, "../resources/textures/dirt.png");
-            if (!dirt_texture_)
+            rain_budget_ += kRainPerSecond * dt;
+            for (; rain_budget_ >= 1.0f; rain_budget_ -= 1.0f)
             {
-                throw std::runtime_error("Failed to load dirt texture");
+                float x = -2.0f + unit(random) * (kMapWidth + 4);
+                float y = -2.0f + unit(random) * (kMapHeight + 4);
+                particles_.Spawn({x, y, kRainHeight * (0.5f + unit(random)), 0.6f, 0.6f, -14.0f, -10.0f, 2.0f, 3.0f,
+                                  {170u, 190u, 255u, 160u}});
             }
         }
-        if (stone_texture_ == nullptr)
+
+        if (player_.IsMoving())
         {
-            stone_texture_ = IMG_LoadTexture(renderer, "../resources/textures/stone.png");
-            if (!stone_texture_)
+            TileCoord position = player_.GetPosition();
+            GridPoint tile = PlayerTile();
+            float ground = static_cast<float>(map_.At(tile.x, tile.y).elevation) * kElevationStep;
+            dust_budget_ += kDustPerSecond * dt;
+            for (; dust_budget_ >= 1.0f; dust_budget_ -= 1.0f)
             {
-                throw std::runtime_error("Failed to load stone texture");
+                particles_.Spawn({position.x + (unit(random) - 0.5f) * 0.4f, position.y + (unit(random) - 0.5f) * 0.4f,
+                                  ground, (unit(random) - 0.5f) * 0.6f, (unit(random) - 0.5f) * 0.6f,
+                                  0.4f + unit(random) * 0.4f, -1.5f, 0.8f, 7.0f, {170u, 140u, 100u, 120u}});
             }
         }
+    }
 
-        // Update camera bounds
-        UpdateCameraBounds(renderer);
-
-        // Clear renderer
-        renderer.Clear(sdl::kColorDarkGrey);
+    // Ring of sparks spreading out from a tile
+    void BurstAt(GridPoint tile)
+    {
+        float ground = map_.InBounds(tile.x, tile.y) ? map_.At(tile.x, tile.y).elevation * kElevationStep : 0.0f;
+        std::minstd_rand& random = particles_.Random();
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        for (int i = 0; i < kRallyBurstCount; ++i)
+        {
+            float angle = static_cast<float>(i) / kRallyBurstCount * 6.2831853f;
+            float speed = 1.0f + unit(random);
+            particles_.Spawn({static_cast<float>(tile.x), static_cast<float>(tile.y), ground, std::cos(angle) * speed,
+                              std::sin(angle) * speed, 1.0f + unit(random) * 1.5f, -2.5f, 1.2f, 5.0f,
+                              {255u, 210u, 90u, 230u}});
+        }
+    }
 
-        // Draw map
-        for (int row = 0; row < kMapHeight; ++row)
+    // Move NPCs that reached their tile on to the next one of the rally flow
+    // field; once none of them has anywhere left to go the field is dropped
+    // and they wander again
+    void SteerNpcs()
+    {
+        auto& target_x = entities_.TargetsX();
+        auto& target_y = entities_.TargetsY();
+        bool steering = false;
+        for (size_t i = 0; i < entities_.Size(); ++i)
         {
-            for (int col = 0; col < kMapWidth; ++col)
+            if (!entities_.HasArrived(i))
+            {
+                steering = true;
+                continue;
+            }
+            GridPoint next;
+            if (rally_field_->NextStep(static_cast<int>(std::round(target_x[i])), static_cast<int>(std::round(target_y[i])), next))
             {
-                Tile& tile = map_[row][col];
-                TileCoord coord = {static_cast<float>(col), static_cast<float>(row)};
-                DrawTile(renderer, coord, MaterialToTexture(tile.material));
+                target_x[i] = static_cast<float>(next.x);
+                target_y[i] = static_cast<float>(next.y);
+                steering = true;
             }
         }
+        if (!steering)
+        {
+            rally_field_.reset();
+        }
+    }
 
-        // Draw player
-        DrawTile(renderer, player_.GetPosition(), player_.GetColor());
+    // Give idle NPCs a new nearby target now and then; NPCs that can see the player stay and watch
+    void WanderNpcs(GridPoint player_tile)
+    {
+        auto& target_x = entities_.TargetsX();
+        auto& target_y = entities_.TargetsY();
+        const auto& ids = entities_.GetIds();
+        for (size_t i = 0; i < entities_.Size(); ++i)
+        {
+            if (!entities_.HasArrived(i) || fov_.CanSee(npc_viewers_[ids[i]], player_tile.x, player_tile.y) ||
+                rng_() % kNpcWanderChance != 0)
+            {
+                continue;
+            }
+            int span = 2 * kNpcWanderRadius + 1;
+            float x = target_x[i] + static_cast<float>(static_cast<int>(rng_() % span) - kNpcWanderRadius);
+            float y = target_y[i] + static_cast<float>(static_cast<int>(rng_() % span) - kNpcWanderRadius);
+            x = std::clamp(x, 0.0f, static_cast<float>(kMapWidth - 1));
+            y = std::clamp(y, 0.0f, static_cast<float>(kMapHeight - 1));
+            if (IsWalkableLine(target_x[i], target_y[i], x, y))
+            {
+                target_x[i] = x;
+                target_y[i] = y;
+            }
+        }
+    }
 
-        // Draw mouse hover
-        if (mouse_position_valid_)
+    // Whether every tile a straight walk from one point to another crosses,
+    // except the one it starts on, can be walked on
+    bool IsWalkableLine(float from_x, float from_y, float to_x, float to_y) const
+    {
+        const int samples = static_cast<int>(std::ceil(std::max(std::abs(to_x - from_x), std::abs(to_y - from_y)) * 2.0f));
+        for (int s = 1; s <= samples; ++s)
         {
-            DrawTile(renderer, PixelToTile(mouse_position_, true), kHoverColor);
+            float t = static_cast<float>(s) / samples;
+            int x = static_cast<int>(std::round(from_x + (to_x - from_x) * t));
+            int y = static_cast<int>(std::round(from_y + (to_y - from_y) * t));
+            if (!map_.InBounds(x, y) || TileMoveCost(map_.At(x, y)) == 0)
+            {
+                return false;
+            }
         }
-    };
+        return true;
+    }
 
-private:
-    std::array<std::array<Tile, kMapWidth>, kMapHeight> map_;
-    PixelCoord offset_ = {400.0f, 150.0f};
+    void HandleEvent(const SDL_Event& event)
+    {
+        if (event.type == SDL_EVENT_KEY_DOWN)
+        {
+            switch (event.key.key)
+            {
+                case SDLK_UP:
+                    StepPlayer(-1, -1);
+                    break;
+                case SDLK_DOWN:
+                    StepPlayer(1, 1);
+                    break;
+                case SDLK_LEFT:
+                    StepPlayer(-1, 1);
+                    break;
+                case SDLK_RIGHT:
+                    StepPlayer(1, -1);
+                    break;
+                case SDLK_P:
+                    id_picking_ = !id_picking_;
+                    break;
+                case SDLK_R:
+                    raining_ = !raining_;
+                    break;
+                case SDLK_M:
+                    show_minimap_ = !show_minimap_;
+                    break;
+                case SDLK_0:
+                    brush_ = Brush::NONE;
+                    break;
+                case SDLK_1:
+                    brush_ = Brush::GRASS;
+                    break;
+                case SDLK_2:
+                    brush_ = Brush::DIRT;
+                    break;
+                case SDLK_3:
+                    brush_ = Brush::WALL;
+                    break;
+            }
+        }
+
+        if (event.type == SDL_EVENT_MOUSE_BUTTON_DOWN)
+        {
+            if (event.button.button == SDL_BUTTON_LEFT && brush_ != Brush::NONE)
+            {
+                Paint(ClickedTile(event.button.x, event.button.y));
+            }
+            else if (event.button.button == SDL_BUTTON_LEFT)
+            {
+                // Ask for a path to the clicked tile; the player starts walking
+                // once a worker thread has solved it
+                player_path_request_ = pathfinder_.Request(PlayerTile(), ClickedTile(event.button.x, event.button.y));
+            }
+            else if (event.button.button == SDL_BUTTON_RIGHT)
+            {
+                // Rally every NPC to the clicked tile with one shared flow field
+                GridPoint rally_point = ClickedTile(event.button.x, event.button.y);
+                rally_request_ = pathfinder_.RequestFlowField(rally_point);
+                rally_field_stale_ = false;
+                BurstAt(rally_point);
+            }
+        }
+
+        if (event.type == SDL_EVENT_MOUSE_MOTION)
+        {
+            mouse_position_.x = event.motion.x;
+            mouse_position_.y = event.motion.y;
+            mouse_position_valid_ = true;
+
+            // Drag to keep painting
+            if (brush_ != Brush::NONE && (event.motion.state & SDL_BUTTON_LMASK) != 0)
+            {
+                Paint(ClickedTile(event.motion.x, event.motion.y));
+            }
+        }
+
+        if (event.type == SDL_EVENT_MOUSE_WHEEL)
+        {
+            // Zoom in/out based on wheel direction; one step per wheel notch,
+            // the event router sums the notches of a frame into a single event
+            if (event.wheel.y > 0)
+            {
+                ZoomIn(std::pow(1.1f, event.wheel.y));  // Scroll up = zoom in
+            }
+            else if (event.wheel.y < 0)
+            {
+                ZoomOut(std::pow(0.9f, -event.wheel.y));  // Scroll down = zoom out
+            }
+        }
+    }
+
+    // Apply the current brush around a tile; the edits reach the rest of the game on the next update
+    void Paint(GridPoint center)
+    {
+        for (int dy = -kBrushRadius; dy <= kBrushRadius; ++dy)
+        {
+            for (int dx = -kBrushRadius; dx <= kBrushRadius; ++dx)
+            {
+                int x = center.x + dx;
+                int y = center.y + dy;
+                if (!map_.InBounds(x, y))
+                {
+                    continue;
+                }
+                Tile tile = map_.At(x, y);
+                switch (brush_)
+                {
+                    case Brush::NONE:
+                        return;
+                    case Brush::GRASS:
+                        tile.material = Material::GRASS;
+                        tile.object = TileObject::NONE;
+                        break;
+                    case Brush::DIRT:
+                        tile.material = Material::DIRT;
+                        tile.object = TileObject::NONE;
+                        break;
+                    case Brush::WALL:
+                        tile.material = Material::STONE;
+                        tile.object = TileObject::WALL;
+                        break;
+                }
+                map_.SetTile(x, y, tile);
+            }
+        }
+    }
+
+    // Step the player one tile, unless the tile is blocked
+    void StepPlayer(int dx, int dy)
+    {
+        TileCoord target = player_.GetTargetPosition();
+        int x = static_cast<int>(std::round(target.x)) + dx;
+        int y = static_cast<int>(std::round(target.y)) + dy;
+        bool occupied = npc_hash_.FindNearest(static_cast<float>(x), static_cast<float>(y), kNpcRadius) != kInvalidEntity;
+        if (map_.InBounds(x, y) && TileMoveCost(map_.At(x, y)) != 0 && !occupied)
+        {
+            player_path_request_ = kNoPathRequest;
+            player_.MoveBy(static_cast<float>(dx), static_cast<float>(dy));
+        }
+    }
+
+    void OffsetMove(float dx, float dy)
+    {
+        offset_.x += dx;
+        offset_.y += dy;
+        UpdateCamera();
+    }
+
+    void DrawTile(sdl::CommandBuffer& commands, const TileCoord& position, sdl::Color color)
+    {
+        DrawTileAt(commands, TileToPixel(position), color);
+    }
+
+    void DrawTile(sdl::CommandBuffer& commands, const TileCoord& position, SDL_Texture* texture)
+    {
+        DrawTileAt(commands, TileToPixel(position), texture);
+    }
+
+    // Draw a tile centered at an already transformed screen position
+    void DrawTileAt(sdl::CommandBuffer& commands, const PixelCoord& pixel_pos, sdl::Color color)
+    {
+        SDL_FColor fcolor = {color.r / 255.0f, color.g / 255.0f,
+                             color.b / 255.0f, color.a / 255.0f};
+        DrawDiamondAt(commands, pixel_pos, fcolor);
+    }
+
+    void DrawDiamondAt(sdl::CommandBuffer& commands, const PixelCoord& pixel_pos, SDL_FColor fcolor)
+    {
+        SDL_Vertex diamond[4];
+        DiamondVertices(pixel_pos, tile_width_, tile_height_, fcolor, diamond);
+        commands.Geometry(nullptr, diamond, kDiamondIndices);
+    }
+
+    // Left and right faces below a raised tile centered at top_pos, `height` pixels tall
+    void DrawSidesAt(sdl::CommandBuffer& commands, const PixelCoord& top_pos, float height, sdl::Color color)
+    {
+        DrawSidesAt(commands, top_pos, height, ShadeSide(color, 0.7f), ShadeSide(color, 0.5f));
+    }
+
+    void DrawSidesAt(sdl::CommandBuffer& commands, const PixelCoord& top_pos, float height, SDL_FColor left, SDL_FColor right)
+    {
+        SDL_Vertex faces[8];
+        SideVertices(top_pos, tile_width_, tile_height_, height, left, right, faces);
+        commands.Geometry(nullptr, faces, kSideIndices);
+    }
+
+    // Tile geometry for any tile size, shared by the helpers above and the terrain meshes
+    static constexpr int kDiamondIndices[] = {0, 1, 2, 0, 2, 3};
+    static constexpr int kSideIndices[] = {0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7};
+
+    // The UVs are the edge midpoints of a tile texture, where its masked diamond touches the edges
+    static void DiamondVertices(const PixelCoord& center, float width, float height, SDL_FColor color,
+                                SDL_Vertex (&diamond)[4])
+    {
+        const float x = center.x;
+        const float y = center.y;
+        diamond[0] = {{x, y - height / 2.0f}, color, {0.5f, 0.0f}};  // top
+        diamond[1] = {{x + width / 2.0f, y}, color, {1.0f, 0.5f}};   // right
+        diamond[2] = {{x, y + height / 2.0f}, color, {0.5f, 1.0f}};  // bottom
+        diamond[3] = {{x - width / 2.0f, y}, color, {0.0f, 0.5f}};   // left
+    }
+
+    static void SideVertices(const PixelCoord& top, float width, float height, float depth, SDL_FColor left,
+                             SDL_FColor right, SDL_Vertex (&faces)[8])
+    {
+        const float x = top.x;
+        const float y = top.y;
+        faces[0] = {{x - width / 2.0f, y}, left, {0.0f, 0.0f}};                   // left
+        faces[1] = {{x, y + height / 2.0f}, left, {0.0f, 0.0f}};                  // bottom
+        faces[2] = {{x, y + height / 2.0f + depth}, left, {0.0f, 0.0f}};          // bottom, lowered
+        faces[3] = {{x - width / 2.0f, y + depth}, left, {0.0f, 0.0f}};           // left, lowered
+        faces[4] = {{x, y + height / 2.0f}, right, {0.0f, 0.0f}};                 // bottom
+        faces[5] = {{x + width / 2.0f, y}, right, {0.0f, 0.0f}};                  // right
+        faces[6] = {{x + width / 2.0f, y + depth}, right, {0.0f, 0.0f}};          // right, lowered
+        faces[7] = {{x, y + height / 2.0f + depth}, right, {0.0f, 0.0f}};         // bottom, lowered
+    }
+
+    static SDL_FColor ShadeSide(sdl::Color color, float light)
+    {
+        return {color.r / 255.0f * light, color.g / 255.0f * light, color.b / 255.0f * light, color.a / 255.0f};
+    }
+
+    // Only the diamond of the texture is drawn, its transparent corners are never touched
+    void DrawTileAt(sdl::CommandBuffer& commands, const PixelCoord& pixel_pos, SDL_Texture* texture)
+    {
+        SDL_Vertex diamond[4];
+        DiamondVertices(pixel_pos, tile_width_, tile_height_, {1.0f, 1.0f, 1.0f, 1.0f}, diamond);
+        commands.Geometry(texture, diamond, kDiamondIndices);
+    }
+
+    // Sort depth of what stands on an iso diagonal: its ground, then objects,
+    // then units. Depth 0 stays free for backgrounds.
+    enum class DepthSlot : uint32_t
+    {
+        GROUND_SIDES,
+        GROUND_TOP,
+        GROUND_FOG,
+        SIDES,
+        TOP,
+        UNIT,
+        COUNT
+    };
+    static uint32_t DepthOf(int diagonal, DepthSlot slot)
+    {
+        return 1 + static_cast<uint32_t>(std::max(diagonal, 0)) * static_cast<uint32_t>(DepthSlot::COUNT) +
+               static_cast<uint32_t>(slot);
+    }
+
+    void UpdateCameraBounds()
+    {
+        const auto& window_size = viewport_;
+
+        // Camera following logic - keep player in center area
+        PixelCoord player_screen_pos = TileToPixel(player_.GetPosition());
+
+        // Calculate center area boundaries using the deadzone divisor
+        // For divisor=5: center area is middle 1/5 of screen, camera follows in outer 4/5
+        float margin_size = window_size.width / kCameraDeadzoneDivisor;
+        float center_left_bound = (window_size.width - margin_size) / 2.0f;
+        float center_right_bound = (window_size.width + margin_size) / 2.0f;
+
+        float margin_size_y = window_size.height / kCameraDeadzoneDivisor;
+        float center_top_bound = (window_size.height - margin_size_y) / 2.0f;
+        float center_bottom_bound = (window_size.height + margin_size_y) / 2.0f;
+
+        // Check if player is outside center area and adjust camera
+        bool needs_camera_update = false;
+        PixelCoord new_offset = offset_;
+
+        if (player_screen_pos.x < center_left_bound)
+        {
+            new_offset.x = offset_.x + (center_left_bound - player_screen_pos.x);
+            needs_camera_update = true;
+        }
+        else if (player_screen_pos.x > center_right_bound)
+        {
+            new_offset.x = offset_.x + (center_right_bound - player_screen_pos.x);
+            needs_camera_update = true;
+        }
+
+        if (player_screen_pos.y < center_top_bound)
+        {
+            new_offset.y = offset_.y + (center_top_bound - player_screen_pos.y);
+            needs_camera_update = true;
+        }
+        else if (player_screen_pos.y > center_bottom_bound)
+        {
+            new_offset.y = offset_.y + (center_bottom_bound - player_screen_pos.y);
+            needs_camera_update = true;
+        }
+
+        if (needs_camera_update)
+        {
+            offset_ = new_offset;
+            UpdateCamera();
+            // mouse_position_valid_ = false;
+        }
+    }
+
+    // Upload the decoded tile textures, waiting for the decode jobs if they are still running
+    void LoadTextures(sdl::Renderer& renderer)
+    {
+        jobs_.Wait(texture_jobs_);
+
+        SDL_Texture** textures[] = {&grass_texture_, &dirt_texture_, &stone_texture_};
+        for (size_t i = 0; i < kTextureFiles.size(); ++i)
+        {
+            if (*textures[i] != nullptr)
+            {
+                continue;
+            }
+            SDL_Surface* surface = decoded_textures_[i];
+            decoded_textures_[i] = nullptr;
+            if (surface)
+            {
+                *textures[i] = SDL_CreateTextureFromSurface(renderer, surface);
+                SDL_DestroySurface(surface);
+            }
+            if (!*textures[i])
+            {
+                throw std::runtime_error(std::string("Failed to load ") + kTextureFiles[i].name + " texture");
+            }
+        }
+
+        if (!unit_atlas_.IsLoaded())
+        {
+            SDL_Surface* sheet = CreateUnitSheet(false);
+            SDL_Surface* silhouettes = CreateUnitSheet(true);
+            if (!sheet || !silhouettes)
+            {
+                SDL_DestroySurface(sheet);
+                SDL_DestroySurface(silhouettes);
+                throw std::runtime_error("Failed to create the unit sprite sheet");
+            }
+            unit_atlas_.Create(renderer, sheet, kUnitFrameWidth, kUnitFrameHeight);
+            unit_pick_atlas_.Create(renderer, silhouettes, kUnitFrameWidth, kUnitFrameHeight);
+            SDL_DestroySurface(sheet);
+            SDL_DestroySurface(silhouettes);
+            SDL_SetTextureScaleMode(unit_atlas_.GetTexture(), SDL_SCALEMODE_NEAREST);
+            SDL_SetTextureScaleMode(unit_pick_atlas_.GetTexture(), SDL_SCALEMODE_NEAREST);
+        }
+
+        if (!particle_atlas_.IsLoaded())
+        {
+            SDL_Surface* sheet = CreateParticleSheet();
+            if (!sheet)
+            {
+                throw std::runtime_error("Failed to create the particle texture");
+            }
+            particle_atlas_.Create(renderer, sheet, kParticleTextureSize, kParticleTextureSize);
+            SDL_DestroySurface(sheet);
+        }
+    }
+
+    // Soft white dot, tinted per particle
+    static SDL_Surface* CreateParticleSheet()
+    {
+        SDL_Surface* sheet = SDL_CreateSurface(kParticleTextureSize, kParticleTextureSize, SDL_PIXELFORMAT_RGBA32);
+        if (!sheet || !SDL_LockSurface(sheet))
+        {
+            if (sheet)
+            {
+                SDL_DestroySurface(sheet);
+            }
+            return nullptr;
+        }
+        const float center = (kParticleTextureSize - 1) / 2.0f;
+        for (int y = 0; y < kParticleTextureSize; ++y)
+        {
+            auto* row = reinterpret_cast<Uint32*>(static_cast<Uint8*>(sheet->pixels) + y * sheet->pitch);
+            for (int x = 0; x < kParticleTextureSize; ++x)
+            {
+                float distance = std::hypot(x - center, y - center) / (center + 0.5f);
+                float alpha = std::clamp(1.0f - distance, 0.0f, 1.0f);
+                row[x] = SDL_MapSurfaceRGBA(sheet, 255, 255, 255, static_cast<Uint8>(alpha * alpha * 255.0f));
+            }
+        }
+        SDL_UnlockSurface(sheet);
+        return sheet;
+    }
+
+    /**
+     * Unit sprite sheet, drawn in white so every unit can be tinted with its
+     * own color: two idle frames breathing, then four walking frames lifting
+     * one leg at a time. The silhouette version is plain opaque white without
+     * the shadow: tinted with a pick id it marks exactly the pixels of the unit.
+     */
+    static SDL_Surface* CreateUnitSheet(bool silhouette)
+    {
+        static constexpr int kFrameCount = 6;
+        static constexpr int kBob[kFrameCount] = {0, 1, 0, 1, 0, 1};
+        static constexpr int kLeftLift[kFrameCount] = {0, 0, 0, 2, 0, 0};
+        static constexpr int kRightLift[kFrameCount] = {0, 0, 0, 0, 0, 2};
+
+        SDL_Surface* sheet = SDL_CreateSurface(kUnitFrameWidth * kFrameCount, kUnitFrameHeight, SDL_PIXELFORMAT_RGBA32);
+        if (!sheet)
+        {
+            return nullptr;
+        }
+        const Uint32 light = SDL_MapSurfaceRGBA(sheet, 255, 255, 255, 255);
+        const Uint32 shade = SDL_MapSurfaceRGBA(sheet, 190, 190, 190, 255);
+        const Uint32 dark = SDL_MapSurfaceRGBA(sheet, 140, 140, 140, 255);
+        const Uint32 shadow = SDL_MapSurfaceRGBA(sheet, 0, 0, 0, 90);
+        SDL_FillSurfaceRect(sheet, nullptr, SDL_MapSurfaceRGBA(sheet, 0, 0, 0, 0));
+
+        for (int frame = 0; frame < kFrameCount; ++frame)
+        {
+            const int x = frame * kUnitFrameWidth;
+            const int bob = kBob[frame];
+            const SDL_Rect rects[] = {
+                {x + 3, 21, 10, 3},                                   // shadow
+                {x + 4, 15 - kLeftLift[frame], 3, 7},                 // left leg
+                {x + 9, 15 - kRightLift[frame], 3, 7},                // right leg
+                {x + 3, 7 + bob, 10, 9},                              // body
+                {x + 9, 7 + bob, 4, 9},                               // body, shaded side
+                {x + 5, 1 + bob, 6, 6},                               // head
+            };
+            const Uint32 transparent = SDL_MapSurfaceRGBA(sheet, 0, 0, 0, 0);
+            const Uint32 colors[] = {silhouette ? transparent : shadow,
+                                     silhouette ? light : dark,
+                                     silhouette ? light : dark,
+                                     light,
+                                     silhouette ? light : shade,
+                                     light};
+            for (size_t i = 0; i < std::size(rects); ++i)
+            {
+                SDL_FillSurfaceRect(sheet, &rects[i], colors[i]);
+            }
+        }
+        return sheet;
+    }
+
+    // Screen area of a unit sprite standing at a pixel position
+    SDL_FRect UnitRect(const PixelCoord& feet) const
+    {
+        const float width = tile_width_ * kUnitWidth;
+        const float height = width * unit_atlas_.GetFrameAspect();
+        return {feet.x - width / 2.0f, feet.y + tile_height_ * 0.15f - height, width, height};
+    }
+
+    void Render(sdl::Renderer& renderer)
+    {
+        if (grass_texture_ == nullptr || dirt_texture_ == nullptr || stone_texture_ == nullptr || !unit_atlas_.IsLoaded() ||
+            !particle_atlas_.IsLoaded())
+        {
+            LoadTextures(renderer);
+        }
+
+        // Clear renderer
+        renderer.Clear(sdl::kColorDarkGrey);
+
+        // Transform all tile centers in one batch, then put down the cached ground
+        auto window_size = renderer.GetWindowSize();
+        sdl::CommandBuffer& commands = renderer.Commands();
+        TileToPixel(tile_center_x_, tile_center_y_, tile_screen_x_, tile_screen_y_);
+        RenderTerrain(renderer, window_size);
+
+        // Effects are recorded on a worker while the sprites are recorded here
+        JobHandle particles_recorded = jobs_.Schedule([this, window_size]
+                                                      { RecordParticles(window_size); });
+
+        // Objects and entities in painter's order: bucketed by diagonal, objects
+        // before the entities on the same diagonal and the player last
+        sprites_.Begin(kDiagonalCount);
+        for (uint32_t index : object_tiles_)
+        {
+            int col = static_cast<int>(index % kMapWidth);
+            int row = static_cast<int>(index / kMapWidth);
+            sprites_.Add(col + row, {SpriteKind::OBJECT, index});
+        }
+
+        size_t npc_count = entities_.Size();
+        npc_screen_x_.resize(npc_count);
+        npc_screen_y_.resize(npc_count);
+        TileToPixel(entities_.PositionsX(), entities_.PositionsY(), npc_screen_x_, npc_screen_y_);
+        const float unit_height = tile_width_ * kUnitWidth * unit_atlas_.GetFrameAspect();
+        for (size_t i = 0; i < npc_count; ++i)
+        {
+            float x = entities_.PositionsX()[i];
+            float y = entities_.PositionsY()[i];
+            npc_screen_y_[i] -= GroundOffsetAt(x, y);
+            PixelCoord pixel_pos = {npc_screen_x_[i], npc_screen_y_[i] - unit_height};
+            int npc_x = static_cast<int>(std::round(x));
+            int npc_y = static_cast<int>(std::round(y));
+            if (IsOnScreen(pixel_pos, window_size, unit_height) && fov_.CanSee(player_viewer_, npc_x, npc_y))
+            {
+                sprites_.Add(static_cast<int>(std::lround(x + y)), {SpriteKind::NPC, static_cast<uint32_t>(i)});
+            }
+        }
+
+        TileCoord player_pos = player_.GetPosition();
+        sprites_.Add(static_cast<int>(std::lround(player_pos.x + player_pos.y)), {SpriteKind::PLAYER, 0});
+
+        // Units on one diagonal share the atlas, so the command buffer merges
+        // them into one draw call; objects between them in painter's order split it
+        commands.SetLayer(sdl::CommandBuffer::kLayerWorld);
+        const float wall_height = kWallHeight * tile_height_;
+        const auto& npc_color = entities_.Colors();
+        const auto& npc_ids = entities_.GetIds();
+        // Raised ground in front of a sprite, drawn like the cache has it, see RecordOccluders()
+        auto draw_occluder = [&](size_t index, int diagonal, const PixelCoord& top_pos, float raise)
+        {
+            const Tile& tile = map_.GetTiles()[index];
+            commands.SetDepth(DepthOf(diagonal, DepthSlot::GROUND_SIDES));
+            DrawSidesAt(commands, top_pos, raise, MaterialToColor(tile.material));
+            commands.SetDepth(DepthOf(diagonal, DepthSlot::GROUND_TOP));
+            DrawTileAt(commands, top_pos, MaterialToTexture(tile.material));
+            if (!fov_.CanSee(player_viewer_, static_cast<int>(index % kMapWidth), static_cast<int>(index / kMapWidth)))
+            {
+                commands.SetDepth(DepthOf(diagonal, DepthSlot::GROUND_FOG));
+                DrawTileAt(commands, top_pos, kFogColor);
+            }
+        };
+        std::span<const Sprite> sprites = sprites_.Sort();
+        for (const Sprite& sprite : sprites)
+        {
+            RecordOccluders(commands, FootprintOf(sprite), window_size, draw_occluder);
+            switch (sprite.kind)
+            {
+                case SpriteKind::OBJECT:
+                {
+                    const Tile& tile = map_.GetTiles()[sprite.index];
+                    float raise = ElevationOffset(tile.elevation) + wall_height;
+                    PixelCoord top_pos = {tile_screen_x_[sprite.index], tile_screen_y_[sprite.index] - raise};
+                    if (IsOnScreen(top_pos, window_size, raise))
+                    {
+                        int diagonal = static_cast<int>(sprite.index % kMapWidth + sprite.index / kMapWidth);
+                        commands.SetDepth(DepthOf(diagonal, DepthSlot::SIDES));
+                        DrawSidesAt(commands, top_pos, raise, MaterialToColor(tile.material));
+                        commands.SetDepth(DepthOf(diagonal, DepthSlot::TOP));
+                        DrawTileAt(commands, top_pos, MaterialToTexture(tile.material));
+                    }
+                    break;
+                }
+                case SpriteKind::NPC:
+                {
+                    float x = entities_.PositionsX()[sprite.index];
+                    float y = entities_.PositionsY()[sprite.index];
+                    sdl::Color color = npc_color[sprite.index];
+                    commands.SetDepth(DepthOf(static_cast<int>(std::lround(x + y)), DepthSlot::UNIT));
+                    unit_atlas_.Draw(commands, animator_.GetFrame(kFirstNpcAnimation + npc_ids[sprite.index]),
+                                     UnitRect({npc_screen_x_[sprite.index], npc_screen_y_[sprite.index]}),
+                                     {color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f});
+                    break;
+                }
+                case SpriteKind::PLAYER:
+                {
+                    PixelCoord pixel_pos = TileToPixel(player_pos);
+                    pixel_pos.y -= GroundOffsetAt(player_pos.x, player_pos.y);
+                    sdl::Color color = player_.GetColor();
+                    commands.SetDepth(DepthOf(static_cast<int>(std::lround(player_pos.x + player_pos.y)), DepthSlot::UNIT));
+                    unit_atlas_.Draw(commands, animator_.GetFrame(kPlayerAnimation), UnitRect(pixel_pos),
+                                     {color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f});
+                    break;
+                }
+            }
+        }
+
+        // Draw mouse hover, on the NPC under the cursor if there is one
+        commands.SetLayer(sdl::CommandBuffer::kLayerEffects);
+        commands.SetDepth(1);  // above the particles
+        if (mouse_position_valid_ && id_picking_)
+        {
+            RenderPickIds(renderer, sprites);
+            hovered_pick_ = pick_buffer_.Pick(renderer, mouse_position_.x, mouse_position_.y);
+            picked_at_ = mouse_position_;
+            if (hovered_pick_ >= kEntityPickBase)
+            {
+                size_t index = entities_.IndexOf(hovered_pick_ - kEntityPickBase);
+                DrawTileAt(commands, {npc_screen_x_[index], npc_screen_y_[index]}, kHoverColor);
+            }
+            else if (hovered_pick_ != PickBuffer::kNone)
+            {
+                size_t index = hovered_pick_ - 1;
+                const Tile& tile = map_.GetTiles()[index];
+                float raise = ElevationOffset(tile.elevation) + (tile.object != TileObject::NONE ? wall_height : 0.0f);
+                DrawTileAt(commands, {tile_screen_x_[index], tile_screen_y_[index] - raise}, kHoverColor);
+            }
+        }
+        else if (mouse_position_valid_)
+        {
+            TileCoord hover = PixelToTile(mouse_position_);
+            EntityId hovered_npc = npc_hash_.FindNearest(hover.x, hover.y, kNpcRadius);
+            if (hovered_npc != kInvalidEntity)
+            {
+                size_t index = entities_.IndexOf(hovered_npc);
+                DrawTileAt(commands, {npc_screen_x_[index], npc_screen_y_[index]}, kHoverColor);
+            }
+            else
+            {
+                TileCoord tile = PixelToTile(mouse_position_, true);
+                PixelCoord pixel_pos = TileToPixel(tile);
+                pixel_pos.y -= GroundOffsetAt(tile.x, tile.y);
+                DrawTileAt(commands, pixel_pos, kHoverColor);
+            }
+        }
+
+        if (show_minimap_)
+        {
+            RenderMinimap(renderer, window_size);
+        }
+
+        jobs_.Wait(particles_recorded);
+        renderer.AddCommands(particle_commands_);
+    };
+
+private:
+    // Things drawn in painter's order on top of the ground
+    enum class SpriteKind : uint8_t
+    {
+        OBJECT,  // index into the map tiles
+        NPC,     // index into the entity store
+        PLAYER
+    };
+    struct Sprite
+    {
+        SpriteKind kind;
+        uint32_t index;
+    };
+
+    // Where a sprite stands and what it covers on screen
+    struct SpriteFootprint
+    {
+        int diagonal;  // col + row of its tile
+        int across;    // col - row of its tile
+        float ground;  // elevation offset of what it stands on
+        SDL_FRect rect;
+    };
+
+    SpriteFootprint FootprintOf(const Sprite& sprite) const
+    {
+        switch (sprite.kind)
+        {
+            case SpriteKind::OBJECT:
+            {
+                const int col = static_cast<int>(sprite.index % kMapWidth);
+                const int row = static_cast<int>(sprite.index / kMapWidth);
+                const float ground = ElevationOffset(map_.GetTiles()[sprite.index].elevation);
+                const float raise = ground + kWallHeight * tile_height_;
+                return {col + row, col - row, ground,
+                        {tile_screen_x_[sprite.index] - tile_width_ / 2.0f,
+                         tile_screen_y_[sprite.index] - raise - tile_height_ / 2.0f, tile_width_, raise + tile_height_}};
+            }
+            case SpriteKind::NPC:
+            {
+                const float x = entities_.PositionsX()[sprite.index];
+                const float y = entities_.PositionsY()[sprite.index];
+                return {static_cast<int>(std::lround(x + y)), static_cast<int>(std::lround(x - y)), GroundOffsetAt(x, y),
+                        UnitRect({npc_screen_x_[sprite.index], npc_screen_y_[sprite.index]})};
+            }
+            case SpriteKind::PLAYER:
+                break;
+        }
+        const TileCoord position = player_.GetPosition();
+        const float ground = GroundOffsetAt(position.x, position.y);
+        PixelCoord feet = TileToPixel(position);
+        feet.y -= ground;
+        return {static_cast<int>(std::lround(position.x + position.y)),
+                static_cast<int>(std::lround(position.x - position.y)), ground, UnitRect(feet)};
+    }
+
+    /**
+     * Draw the raised tiles in front of a sprite once more, clipped to the
+     * sprite, so slopes and cliffs it stands behind hide it. The ground is
+     * cached beneath the whole world layer; only these few tiles have to be
+     * sorted with the sprites. Tiles no higher than the sprite's own ground
+     * cannot reach its rect, apart from the sliver its feet stand over; at
+     * the far zoom, where nothing is raised, no tile is drawn again.
+     *
+     * draw_tile(index, diagonal, top_pos, raise) records one tile at the
+     * ground depths of its diagonal.
+     */
+    template <typename DrawTile>
+    void RecordOccluders(sdl::CommandBuffer& commands, const SpriteFootprint& footprint,
+                         const sdl::Renderer::WindowSize& window_size, DrawTile&& draw_tile)
+    {
+        const float max_raise = ElevationOffset(Tile::kMaxElevation);
+        const SDL_FRect window = {0.0f, 0.0f, window_size.width, window_size.height};
+        SDL_FRect visible;
+        if (max_raise <= footprint.ground ||
+            !SDL_GetRectIntersectionFloat(&footprint.rect, &window, &visible))
+        {
+            return;
+        }
+
+        // A tile k diagonals in front sits k half tiles lower; past this it cannot reach up to the sprite
+        const int reach = 2 + static_cast<int>(std::ceil(2.0f * max_raise / tile_height_));
+        const int side = 1 + static_cast<int>(std::ceil(footprint.rect.w / tile_width_));
+        bool clipped = false;
+        for (int diagonal = footprint.diagonal + 1; diagonal <= footprint.diagonal + reach; ++diagonal)
+        {
+            for (int across = footprint.across - side; across <= footprint.across + side; ++across)
+            {
+                if (((diagonal + across) & 1) != 0)
+                {
+                    continue;
+                }
+                const int col = (diagonal + across) / 2;
+                const int row = (diagonal - across) / 2;
+                if (!map_.InBounds(col, row))
+                {
+                    continue;
+                }
+                const size_t index = map_.IndexOf(col, row);
+                const float raise = ElevationOffset(map_.GetTiles()[index].elevation);
+                const SDL_FRect bounds = {tile_screen_x_[index] - tile_width_ / 2.0f,
+                                          tile_screen_y_[index] - tile_height_ / 2.0f - raise, tile_width_,
+                                          tile_height_ + raise};
+                if (raise <= footprint.ground || !SDL_HasRectIntersectionFloat(&bounds, &visible))
+                {
+                    continue;
+                }
+                if (!clipped)
+                {
+                    const SDL_Rect clip = {static_cast<int>(std::floor(visible.x)), static_cast<int>(std::floor(visible.y)),
+                                           static_cast<int>(std::ceil(visible.x + visible.w) - std::floor(visible.x)),
+                                           static_cast<int>(std::ceil(visible.y + visible.h) - std::floor(visible.y))};
+                    commands.SetClip(&clip);
+                    clipped = true;
+                }
+                draw_tile(index, diagonal, PixelCoord{tile_screen_x_[index], tile_screen_y_[index] - raise}, raise);
+            }
+        }
+        if (clipped)
+        {
+            commands.SetClip(nullptr);
+        }
+    }
+
+    /**
+     * Blit the ground layer from the terrain cache, redrawing the cache first
+     * when it cannot cover the window any more: after a zoom, a scroll past
+     * the margin, a resize or Reset(). Tile edits and changes of what the
+     * player sees only rebuild and redraw the chunks they touched; the cache
+     * is redrawn from the kept meshes otherwise.
+     */
+    void RenderTerrain(sdl::Renderer& renderer, const sdl::Renderer::WindowSize& window_size)
+    {
+        const int cache_width = static_cast<int>(std::ceil(window_size.width + 2.0f * kTerrainCacheMargin));
+        const int cache_height = static_cast<int>(std::ceil(window_size.height + 2.0f * kTerrainCacheMargin));
+        const uint32_t fov_version = fov_.GetVersion(player_viewer_);
+        bool stale = terrain_dirty_ || terrain_tile_width_ != tile_width_ ||
+                     std::abs(offset_.x - terrain_offset_.x) > kTerrainCacheMargin ||
+                     std::abs(offset_.y - terrain_offset_.y) > kTerrainCacheMargin;
+        if (terrain_cache_.Resize(renderer, cache_width, cache_height))
+        {
+            SDL_SetTextureScaleMode(terrain_cache_, SDL_SCALEMODE_NEAREST);
+            SDL_SetTextureBlendMode(terrain_cache_, SDL_BLENDMODE_NONE);
+            stale = true;
+        }
+
+        // Only the chunks where the fog moved
+        if (terrain_fov_version_ != fov_version)
+        {
+            const VisibleSet& visible = fov_.GetVisible(player_viewer_);
+            for (int chunk_y = 0; chunk_y < map_.GetChunksY(); ++chunk_y)
+            {
+                for (int chunk_x = 0; chunk_x < map_.GetChunksX(); ++chunk_x)
+                {
+                    if (visible.GetChunkBits(chunk_x, chunk_y) != terrain_fog_.GetChunkBits(chunk_x, chunk_y))
+                    {
+                        terrain_dirty_chunks_.Set(static_cast<size_t>(chunk_y) * map_.GetChunksX() + chunk_x);
+                    }
+                }
+            }
+            terrain_fog_ = visible;
+            terrain_fov_version_ = fov_version;
+        }
+        BuildTerrainMeshes();
+
+        if (stale)
+        {
+            SDL_SetRenderTarget(renderer, terrain_cache_);
+            renderer.Clear(sdl::kColorDarkGrey);
+            RecordTerrain(renderer, terrain_commands_, {kTerrainCacheMargin + offset_.x, kTerrainCacheMargin + offset_.y},
+                          {0.0f, 0.0f, static_cast<float>(cache_width), static_cast<float>(cache_height)});
+            terrain_commands_.Submit(renderer);
+            SDL_SetRenderTarget(renderer, nullptr);
+
+            terrain_dirty_ = false;
+            terrain_tile_width_ = tile_width_;
+            terrain_offset_ = offset_;
+            terrain_dirty_chunks_.Clear();
+        }
+        else if (terrain_dirty_chunks_.Any())
+        {
+            RedrawTerrainChunks(renderer);
+        }
+
+        // The cache was drawn at terrain_offset_, shift it to the current one
+        SDL_FRect dest = {
+            std::round(offset_.x - terrain_offset_.x - kTerrainCacheMargin),
+            std::round(offset_.y - terrain_offset_.y - kTerrainCacheMargin),
+            static_cast<float>(cache_width),
+            static_cast<float>(cache_height)};
+        sdl::CommandBuffer& commands = renderer.Commands();
+        commands.SetLayer(sdl::CommandBuffer::kLayerGround);
+        commands.SetDepth(0);
+        commands.Texture(terrain_cache_, nullptr, dest);
+    }
+
+    // Effects above everything on the ground; runs on a worker, into its own buffer
+    void RecordParticles(const sdl::Renderer::WindowSize& window_size)
+    {
+        particle_screen_x_.resize(particles_.Size());
+        particle_screen_y_.resize(particles_.Size());
+        TileToPixel(particles_.PositionsX(), particles_.PositionsY(), particle_screen_x_, particle_screen_y_);
+        particle_commands_.SetLayer(sdl::CommandBuffer::kLayerEffects);
+        particles_.Render(particle_commands_, particle_atlas_.GetTexture(), particle_screen_x_, particle_screen_y_,
+                          tile_height_, tile_width_ / kDefaultTileWidth,
+                          {0.0f, 0.0f, window_size.width, window_size.height});
+    }
+
+    // Minimap with the player and the outline of the window on it
+    void RenderMinimap(sdl::Renderer& renderer, const sdl::Renderer::WindowSize& window_size)
+    {
+        minimap_.SetLayout(window_size.width - kMinimapMargin - kMinimapWidth / 2.0f, kMinimapMargin, kMinimapWidth,
+                           kTileAspectRatio);
+
+        const PixelCoord corners[4] = {
+            {0.0f, 0.0f}, {window_size.width, 0.0f}, {window_size.width, window_size.height}, {0.0f, window_size.height}};
+        std::array<SDL_FPoint, 4> view;
+        for (size_t i = 0; i < view.size(); ++i)
+        {
+            TileCoord tile = PixelToTile(corners[i]);
+            view[i] = {tile.x, tile.y};
+        }
+        TileCoord player = player_.GetPosition();
+        sdl::CommandBuffer& commands = renderer.Commands();
+        commands.SetLayer(sdl::CommandBuffer::kLayerUi);
+        commands.SetDepth(0);
+        minimap_.Render(renderer, commands, {player.x, player.y}, view);
+    }
+
+    // Redraw the dirty chunks of the terrain cache, each clipped to its own screen area
+    void RedrawTerrainChunks(sdl::Renderer& renderer)
+    {
+        // Cache pixels of a tile, for the offset the cache was drawn at
+        const PixelCoord shift = {kTerrainCacheMargin - (offset_.x - terrain_offset_.x),
+                                  kTerrainCacheMargin - (offset_.y - terrain_offset_.y)};
+        const PixelCoord translation = {offset_.x + shift.x, offset_.y + shift.y};
+        const float max_raise = ElevationOffset(Tile::kMaxElevation);
+
+        SDL_SetRenderTarget(renderer, terrain_cache_);
+        auto redraw = [&](size_t chunk)
+        {
+            int first_col = static_cast<int>(chunk % map_.GetChunksX()) * TileMap::kChunkSize;
+            int first_row = static_cast<int>(chunk / map_.GetChunksX()) * TileMap::kChunkSize;
+            int last_col = std::min(first_col + TileMap::kChunkSize, kMapWidth) - 1;
+            int last_row = std::min(first_row + TileMap::kChunkSize, kMapHeight) - 1;
+
+            // The chunk is a diamond on screen; its corner tiles bound it
+            float min_x = std::numeric_limits<float>::max();
+            float min_y = min_x;
+            float max_x = std::numeric_limits<float>::lowest();
+            float max_y = max_x;
+            for (size_t corner : {map_.IndexOf(first_col, first_row), map_.IndexOf(last_col, first_row),
+                                  map_.IndexOf(first_col, last_row), map_.IndexOf(last_col, last_row)})
+            {
+                min_x = std::min(min_x, tile_screen_x_[corner]);
+                max_x = std::max(max_x, tile_screen_x_[corner]);
+                min_y = std::min(min_y, tile_screen_y_[corner]);
+                max_y = std::max(max_y, tile_screen_y_[corner]);
+            }
+            SDL_Rect clip = {
+                static_cast<int>(std::floor(min_x + shift.x - tile_width_ / 2.0f)),
+                static_cast<int>(std::floor(min_y + shift.y - tile_height_ / 2.0f - max_raise)),
+                0, 0};
+            clip.w = static_cast<int>(std::ceil(max_x + shift.x + tile_width_ / 2.0f)) - clip.x;
+            clip.h = static_cast<int>(std::ceil(max_y + shift.y + tile_height_ / 2.0f)) - clip.y;
+
+            // Everything overlapping the area is drawn again, in order, but only the area changes
+            SDL_FRect area = {static_cast<float>(clip.x), static_cast<float>(clip.y),
+                              static_cast<float>(clip.w), static_cast<float>(clip.h)};
+            terrain_commands_.SetClip(&clip);
+            terrain_commands_.SetLayer(sdl::CommandBuffer::kLayerGround);
+            terrain_commands_.SetDepth(0);
+            terrain_commands_.FillRect(area, sdl::kColorDarkGrey);
+            RecordTerrain(renderer, terrain_commands_, translation, area);
+        };
+        terrain_dirty_chunks_.ForEach(redraw);
+        terrain_commands_.Submit(renderer);
+        SDL_SetRenderTarget(renderer, nullptr);
+        terrain_dirty_chunks_.Clear();
+    }
+
+    // Rebuild the meshes of every chunk after Reset(), of the dirty chunks otherwise
+    void BuildTerrainMeshes()
+    {
+        if (terrain_meshes_.size() != map_.GetChunkCount())
+        {
+            terrain_meshes_.resize(map_.GetChunkCount());
+            terrain_meshes_dirty_ = true;
+        }
+        if (terrain_meshes_dirty_)
+        {
+            jobs_.ParallelFor(terrain_meshes_.size(), 1, [this](size_t begin, size_t end)
+                              {
+                                  for (size_t chunk = begin; chunk < end; ++chunk)
+                                  {
+                                      BuildTerrainMesh(chunk);
+                                  }
+                              });
+            for (size_t chunk = 0; chunk < terrain_meshes_.size(); ++chunk)
+            {
+                UpdateFogTexture(chunk);
+            }
+            terrain_meshes_dirty_ = false;
+            return;
+        }
+
+        terrain_rebuild_chunks_.clear();
+        terrain_dirty_chunks_.ForEach([this](size_t chunk)
+                                      { terrain_rebuild_chunks_.push_back(chunk); });
+        jobs_.ParallelFor(terrain_rebuild_chunks_.size(), 1, [this](size_t begin, size_t end)
+                          {
+                              for (size_t i = begin; i < end; ++i)
+                              {
+                                  BuildTerrainMesh(terrain_rebuild_chunks_[i]);
+                              }
+                          });
+        for (size_t chunk : terrain_rebuild_chunks_)
+        {
+            UpdateFogTexture(chunk);
+        }
+    }
+
+    // The player's view of a chunk as one fog pixel per tile, for the far zoom
+    void UpdateFogTexture(size_t chunk)
+    {
+        const int first_col = static_cast<int>(chunk % map_.GetChunksX()) * TileMap::kChunkSize;
+        const int first_row = static_cast<int>(chunk / map_.GetChunksX()) * TileMap::kChunkSize;
+        for (int row = first_row; row < std::min(first_row + TileMap::kChunkSize, kMapHeight); ++row)
+        {
+            for (int col = first_col; col < std::min(first_col + TileMap::kChunkSize, kMapWidth); ++col)
+            {
+                fog_texture_.SetTile(col, row, fov_.CanSee(player_viewer_, col, row) ? sdl::kColorTransparent : kFogColor);
+            }
+        }
+    }
+
+    // Ground tiles of a chunk in world pixels, back to front along the iso
+    // diagonals; the depths keep raised tiles in front of the ones behind
+    // them when the meshes of several chunks are recorded together
+    void BuildTerrainMesh(size_t chunk)
+    {
+        const float width = kDefaultTileWidth;
+        const float height = kDefaultTileWidth * kTileAspectRatio;
+        const int first_col = static_cast<int>(chunk % map_.GetChunksX()) * TileMap::kChunkSize;
+        const int first_row = static_cast<int>(chunk / map_.GetChunksX()) * TileMap::kChunkSize;
+        const int last_col = std::min(first_col + TileMap::kChunkSize, kMapWidth) - 1;
+        const int last_row = std::min(first_row + TileMap::kChunkSize, kMapHeight) - 1;
+        const SDL_FColor fog = {kFogColor.r / 255.0f, kFogColor.g / 255.0f, kFogColor.b / 255.0f, kFogColor.a / 255.0f};
+        const SDL_FColor white = {1.0f, 1.0f, 1.0f, 1.0f};
+
+        TerrainMesh& mesh = terrain_meshes_[chunk];
+        mesh.Clear();
+        for (int diagonal = first_col + first_row; diagonal <= last_col + last_row; ++diagonal)
+        {
+            const int begin_col = std::max(first_col, diagonal - last_row);
+            const int end_col = std::min(last_col, diagonal - first_row);
+            auto top_of = [&](int col)
+            {
+                int row = diagonal - col;
+                float raise = map_.At(col, row).elevation * kElevationStep * height;
+                return PixelCoord{(col - row) * width / 2.0f, (col + row) * height / 2.0f - raise};
+            };
+
+            for (int col = begin_col; col <= end_col; ++col)
+            {
+                const Tile& tile = map_.At(col, diagonal - col);
+                if (tile.elevation > 0)
+                {
+                    sdl::Color color = MaterialToColor(tile.material);
+                    SDL_Vertex faces[8];
+                    SideVertices(top_of(col), width, height, tile.elevation * kElevationStep * height,
+                                 ShadeSide(color, 0.7f), ShadeSide(color, 0.5f), faces);
+                    mesh.SetRun(DepthOf(diagonal, DepthSlot::GROUND_SIDES), nullptr);
+                    mesh.Add(faces, kSideIndices);
+                }
+            }
+            for (int col = begin_col; col <= end_col; ++col)
+            {
+                SDL_Vertex diamond[4];
+                DiamondVertices(top_of(col), width, height, white, diamond);
+                mesh.SetRun(DepthOf(diagonal, DepthSlot::GROUND_TOP), MaterialToTexture(map_.At(col, diagonal - col).material));
+                mesh.Add(diamond, kDiamondIndices);
+            }
+            for (int col = begin_col; col <= end_col; ++col)
+            {
+                if (!fov_.CanSee(player_viewer_, col, diagonal - col))
+                {
+                    SDL_Vertex diamond[4];
+                    DiamondVertices(top_of(col), width, height, fog, diamond);
+                    mesh.SetRun(DepthOf(diagonal, DepthSlot::GROUND_FOG), nullptr);
+                    mesh.Add(diamond, kDiamondIndices);
+                }
+            }
+        }
+    }
+
+    // Record the ground chunks overlapping `area`, zoomed and then moved by `translation`
+    void RecordTerrain(SDL_Renderer* renderer, sdl::CommandBuffer& commands, const PixelCoord& translation,
+                       const SDL_FRect& area)
+    {
+        const float scale = tile_width_ / kDefaultTileWidth;
+        SDL_Texture* colors = nullptr;
+        SDL_Texture* fog = nullptr;
+        if (tile_width_ <= kLodTileWidth)
+        {
+            colors = minimap_.GetTexture(renderer);
+            fog = fog_texture_.Get(renderer);
+        }
+
+        commands.SetLayer(sdl::CommandBuffer::kLayerGround);
+        commands.SetTransform(scale, {translation.x, translation.y});
+        for (size_t chunk = 0; chunk < terrain_meshes_.size(); ++chunk)
+        {
+            const TerrainMesh& mesh = terrain_meshes_[chunk];
+            const SDL_FRect& bounds = mesh.GetBounds();
+            const SDL_FRect placed = {bounds.x * scale + translation.x, bounds.y * scale + translation.y,
+                                      bounds.w * scale, bounds.h * scale};
+            if (mesh.IsEmpty() || !SDL_HasRectIntersectionFloat(&placed, &area))
+            {
+                continue;
+            }
+            if (colors && fog)
+            {
+                RecordChunkLod(commands, chunk, colors, fog);
+            }
+            else
+            {
+                mesh.Record(commands);
+            }
+        }
+        commands.SetTransform(1.0f, {0.0f, 0.0f});
+    }
+
+    // A whole chunk as one flat quad in world pixels, textured with its part of
+    // the per-tile color and fog textures. Tiles are a few pixels wide at this
+    // zoom, so their textures and elevation would not show anyway; all chunks
+    // share the two textures, which makes two draw calls for the whole map.
+    void RecordChunkLod(sdl::CommandBuffer& commands, size_t chunk, SDL_Texture* colors, SDL_Texture* fog)
+    {
+        const int first_col = static_cast<int>(chunk % map_.GetChunksX()) * TileMap::kChunkSize;
+        const int first_row = static_cast<int>(chunk / map_.GetChunksX()) * TileMap::kChunkSize;
+        const int end_col = std::min(first_col + TileMap::kChunkSize, kMapWidth);
+        const int end_row = std::min(first_row + TileMap::kChunkSize, kMapHeight);
+
+        // Tile edges lie half a tile from the centers
+        auto corner = [](int col, int row)
+        {
+            const float x = col - 0.5f;
+            const float y = row - 0.5f;
+            return SDL_FPoint{(x - y) * kDefaultTileWidth / 2.0f, (x + y) * kDefaultTileWidth * kTileAspectRatio / 2.0f};
+        };
+        const float u0 = static_cast<float>(first_col) / kMapWidth;
+        const float v0 = static_cast<float>(first_row) / kMapHeight;
+        const float u1 = static_cast<float>(end_col) / kMapWidth;
+        const float v1 = static_cast<float>(end_row) / kMapHeight;
+        const SDL_FColor white = {1.0f, 1.0f, 1.0f, 1.0f};
+        const SDL_Vertex quad[4] = {
+            {corner(first_col, first_row), white, {u0, v0}},
+            {corner(end_col, first_row), white, {u1, v0}},
+            {corner(end_col, end_row), white, {u1, v1}},
+            {corner(first_col, end_row), white, {u0, v1}},
+        };
+        commands.SetDepth(1);
+        commands.Geometry(colors, quad, kDiamondIndices);
+        commands.SetDepth(2);
+        commands.Geometry(fog, quad, kDiamondIndices);
+    }
+
+    // Draw the same scene as Render() into the pick buffer, every shape filled with its id
+    void RenderPickIds(sdl::Renderer& renderer, std::span<const Sprite> sprites)
+    {
+        pick_buffer_.Begin(renderer);
+
+        auto window_size = renderer.GetWindowSize();
+        pick_commands_.SetLayer(sdl::CommandBuffer::kLayerGround);
+        for (int diagonal = 0; diagonal < kDiagonalCount; ++diagonal)
+        {
+            int first_col = std::max(0, diagonal - (kMapHeight - 1));
+            int last_col = std::min(diagonal, kMapWidth - 1);
+            for (int col = first_col; col <= last_col; ++col)
+            {
+                size_t index = map_.IndexOf(col, diagonal - col);
+                float raise = ElevationOffset(map_.GetTiles()[index].elevation);
+                PixelCoord pixel_pos = {tile_screen_x_[index], tile_screen_y_[index] - raise};
+                if (!IsOnScreen(pixel_pos, window_size, raise))
+                {
+                    continue;
+                }
+                SDL_FColor id = PickBuffer::ColorOf(static_cast<PickId>(index) + 1);
+                if (raise > 0.0f)
+                {
+                    pick_commands_.SetDepth(DepthOf(diagonal, DepthSlot::GROUND_SIDES));
+                    DrawSidesAt(pick_commands_, pixel_pos, raise, id, id);
+                }
+                pick_commands_.SetDepth(DepthOf(diagonal, DepthSlot::GROUND_TOP));
+                DrawDiamondAt(pick_commands_, pixel_pos, id);
+            }
+        }
+
+        // Sprites at the depths of the main pass, with the same ground drawn over them again
+        const float wall_height = kWallHeight * tile_height_;
+        const auto& ids = entities_.GetIds();
+        pick_commands_.SetLayer(sdl::CommandBuffer::kLayerWorld);
+        auto draw_occluder = [&](size_t index, int diagonal, const PixelCoord& top_pos, float raise)
+        {
+            SDL_FColor id = PickBuffer::ColorOf(static_cast<PickId>(index) + 1);
+            pick_commands_.SetDepth(DepthOf(diagonal, DepthSlot::GROUND_SIDES));
+            DrawSidesAt(pick_commands_, top_pos, raise, id, id);
+            pick_commands_.SetDepth(DepthOf(diagonal, DepthSlot::GROUND_TOP));
+            DrawDiamondAt(pick_commands_, top_pos, id);
+        };
+        for (const Sprite& sprite : sprites)
+        {
+            const SpriteFootprint footprint = FootprintOf(sprite);
+            RecordOccluders(pick_commands_, footprint, window_size, draw_occluder);
+            switch (sprite.kind)
+            {
+                case SpriteKind::OBJECT:
+                {
+                    float raise = ElevationOffset(map_.GetTiles()[sprite.index].elevation) + wall_height;
+                    PixelCoord top_pos = {tile_screen_x_[sprite.index], tile_screen_y_[sprite.index] - raise};
+                    SDL_FColor id = PickBuffer::ColorOf(sprite.index + 1);
+                    pick_commands_.SetDepth(DepthOf(footprint.diagonal, DepthSlot::SIDES));
+                    DrawSidesAt(pick_commands_, top_pos, raise, id, id);
+                    pick_commands_.SetDepth(DepthOf(footprint.diagonal, DepthSlot::TOP));
+                    DrawDiamondAt(pick_commands_, top_pos, id);
+                    break;
+                }
+                case SpriteKind::NPC:
+                    // Units are picked by their sprite, only where its silhouette has pixels
+                    pick_commands_.SetDepth(DepthOf(footprint.diagonal, DepthSlot::UNIT));
+                    unit_pick_atlas_.Draw(pick_commands_, animator_.GetFrame(kFirstNpcAnimation + ids[sprite.index]),
+                                          UnitRect({npc_screen_x_[sprite.index], npc_screen_y_[sprite.index]}),
+                                          PickBuffer::ColorOf(kEntityPickBase + ids[sprite.index]));
+                    break;
+                case SpriteKind::PLAYER:
+                {
+                    // The player stands for the tile it is on
+                    TileCoord player_pos = player_.GetPosition();
+                    GridPoint tile = PlayerTile();
+                    if (map_.InBounds(tile.x, tile.y))
+                    {
+                        PixelCoord pixel_pos = TileToPixel(player_pos);
+                        pixel_pos.y -= GroundOffsetAt(player_pos.x, player_pos.y);
+                        pick_commands_.SetDepth(DepthOf(footprint.diagonal, DepthSlot::UNIT));
+                        unit_pick_atlas_.Draw(pick_commands_, animator_.GetFrame(kPlayerAnimation), UnitRect(pixel_pos),
+                                              PickBuffer::ColorOf(static_cast<PickId>(map_.IndexOf(tile.x, tile.y)) + 1));
+                    }
+                    break;
+                }
+            }
+        }
+
+        pick_commands_.Submit(renderer);
+        pick_buffer_.End(renderer);
+    }
+
+    /**
+     * Tile under a click. Uses the pick buffer when it was read at that spot
+     * during the last render, the inverse camera transform otherwise. The pick
+     * buffer only exists when rendering, so deterministic sessions, which may
+     * be replayed without a window, always use the transform.
+     */
+    GridPoint ClickedTile(float x, float y) const
+    {
+        const float tolerance = 1.0f / PickBuffer::kDefaultScale;
+        bool picked_here = std::abs(picked_at_.x - x) <= tolerance && std::abs(picked_at_.y - y) <= tolerance;
+        if (id_picking_ && !deterministic_ && picked_here && hovered_pick_ != PickBuffer::kNone)
+        {
+            if (hovered_pick_ < kEntityPickBase)
+            {
+                size_t index = hovered_pick_ - 1;
+                return {static_cast<int>(index % kMapWidth), static_cast<int>(index / kMapWidth)};
+            }
+            EntityId id = hovered_pick_ - kEntityPickBase;
+            if (entities_.IsAlive(id))
+            {
+                size_t index = entities_.IndexOf(id);
+                return {static_cast<int>(std::round(entities_.PositionsX()[index])),
+                        static_cast<int>(std::round(entities_.PositionsY()[index]))};
+            }
+        }
+        TileCoord tile = PixelToTile(x, y, true);
+        return {static_cast<int>(tile.x), static_cast<int>(tile.y)};
+    }
+
+    GridPoint PlayerTile() const
+    {
+        TileCoord position = player_.GetPosition();
+        return {static_cast<int>(std::round(position.x)), static_cast<int>(std::round(position.y))};
+    }
+
+    // Refresh the precomputed transform; call whenever offset_ or the tile size changes
+    void UpdateCamera()
+    {
+        camera_.Set(tile_width_, tile_height_, offset_.x, offset_.y);
+    }
+
+    // Whether a tile centered at pixel_pos, with side faces `depth` pixels tall below it, overlaps the window
+    bool IsOnScreen(const PixelCoord& pixel_pos, const sdl::Renderer::WindowSize& window_size, float depth = 0.0f) const
+    {
+        return Overlaps(pixel_pos, {0.0f, 0.0f, window_size.width, window_size.height}, depth);
+    }
+
+    bool Overlaps(const PixelCoord& pixel_pos, const SDL_FRect& area, float depth = 0.0f) const
+    {
+        return pixel_pos.x + tile_width_ / 2.0f >= area.x && pixel_pos.x - tile_width_ / 2.0f <= area.x + area.w &&
+               pixel_pos.y + tile_height_ / 2.0f + depth >= area.y && pixel_pos.y - tile_height_ / 2.0f <= area.y + area.h;
+    }
+
+    void RebuildObjectList()
+    {
+        object_tiles_.clear();
+        for (int row = 0; row < kMapHeight; ++row)
+        {
+            for (int col = 0; col < kMapWidth; ++col)
+            {
+                if (map_.At(col, row).object != TileObject::NONE)
+                {
+                    object_tiles_.push_back(static_cast<uint32_t>(map_.IndexOf(col, row)));
+                }
+            }
+        }
+    }
+
+    // Screen pixels the ground of a tile is raised by. The far zoom draws the
+    // ground flat, so whatever stands on it is not raised there either.
+    float ElevationOffset(uint8_t elevation) const
+    {
+        if (tile_width_ <= kLodTileWidth)
+        {
+            return 0.0f;
+        }
+        return static_cast<float>(elevation) * kElevationStep * tile_height_;
+    }
+
+    // Elevation offset of the tile under a tile position, 0 outside the map
+    float GroundOffsetAt(float x, float y) const
+    {
+        int col = static_cast<int>(std::round(x));
+        int row = static_cast<int>(std::round(y));
+        return map_.InBounds(col, row) ? ElevationOffset(map_.At(col, row).elevation) : 0.0f;
+    }
+
+    struct TextureFile
+    {
+        const char* name;
+        const char* path;
+    };
+    static constexpr std::array<TextureFile, 3> kTextureFiles = {{
+        {"grass", "../resources/textures/grass.png"},
+        {"dirt", "../resources/textures/dirt.png"},
+        {"stone", "../resources/textures/stone.png"},
+    }};
+
+    JobSystem& jobs_;
+
+    static constexpr PixelCoord kDefaultOffset = {400.0f, 150.0f};
+
+    TileMap map_{kMapWidth, kMapHeight};
+    PixelCoord offset_ = kDefaultOffset;
     Player player_ = {"Hannah", {255u, 0u, 255u, 200u}};
+    EntityStore entities_;
+    uint32_t seed_ = 0;
+    std::minstd_rand rng_;  // NPC spawns and wandering; only used by one thread at a time
+    bool deterministic_ = false;
+    sdl::Renderer::WindowSize viewport_ = {800.0f, 600.0f};
+    SpatialHash npc_hash_{kMapWidth, kMapHeight};
+
+    // Line of sight of the player and the NPCs
+    FieldOfView fov_;
+    ViewerId player_viewer_ = 0;
+    std::vector<ViewerId> npc_viewers_;  // indexed by EntityId
+
+    // Click-to-move pathfinding
+    Pathfinder pathfinder_;
+    PathRequestId player_path_request_ = kNoPathRequest;
+    std::vector<PathResult> path_results_;
+
+    // NPC rally point, set with a right click
+    PathRequestId rally_request_ = kNoPathRequest;
+    std::shared_ptr<const FlowField> rally_field_;
+    bool rally_field_stale_ = false;  // edited since it was solved, asked for again once editing pauses
+    std::vector<FlowFieldResult> field_results_;
     PixelCoord mouse_position_ = {0.0f, 0.0f};
     bool mouse_position_valid_ = false;
 
     // Zoom-related member variables
     float tile_width_ = kDefaultTileWidth;
     float tile_height_ = kDefaultTileWidth * kTileAspectRatio;
+    CameraTransform camera_;
+
+    // Depth-sorted drawing of everything standing on the ground
+    std::vector<uint32_t> object_tiles_;  // tiles with an object, in row-major order
+    DepthBuckets<Sprite> sprites_;
+
+    // Animated units, see CreateUnitSheet()
+    static constexpr int kUnitFrameWidth = 16;
+    static constexpr int kUnitFrameHeight = 24;
+    SpriteAtlas unit_atlas_;
+    SpriteAtlas unit_pick_atlas_;  // silhouettes of the same frames, for the pick buffer
+    SpriteAnimator animator_;
+    ClipId idle_clip_ = 0;
+    ClipId walk_clip_ = 0;
+
+    Minimap minimap_{kMapWidth, kMapHeight};
+    TileTexture fog_texture_{kMapWidth, kMapHeight, sdl::kColorTransparent};
+    bool show_minimap_ = true;
+
+    // Weather and effects, see EmitParticles()
+    static constexpr int kParticleTextureSize = 16;
+    ParticleSystem particles_;
+    SpriteAtlas particle_atlas_;
+    bool raining_ = false;
+    float rain_budget_ = 0.0f;  // fractional particles carried over to the next update
+    float dust_budget_ = 0.0f;
+
+    // Ground layer drawn at terrain_offset_, see RenderTerrain()
+    sdl::RenderTarget terrain_cache_;
+    PixelCoord terrain_offset_ = {0.0f, 0.0f};
+    float terrain_tile_width_ = 0.0f;
+    uint32_t terrain_fov_version_ = 0;
+    VisibleSet terrain_fog_;       // the player's view the cache was drawn with
+    ChunkMask terrain_dirty_chunks_;  // chunks to rebuild and redraw before the next blit
+    bool terrain_dirty_ = true;
+
+    // Ground geometry per chunk in world pixels, see BuildTerrainMesh()
+    std::vector<TerrainMesh> terrain_meshes_;
+    std::vector<size_t> terrain_rebuild_chunks_;
+    bool terrain_meshes_dirty_ = true;
+
+    // Off-screen passes and worker-recorded effects, see Render()
+    sdl::CommandBuffer terrain_commands_;
+    sdl::CommandBuffer pick_commands_;
+    sdl::CommandBuffer particle_commands_;
+
+    // Tile edits, see ApplyTileChanges()
+    Brush brush_ = Brush::NONE;
+    std::vector<TileChange> tile_changes_;
+    std::vector<TileCostChange> cost_changes_;
+
+    // Pixel-accurate picking, toggled with P
+    PickBuffer pick_buffer_;
+    bool id_picking_ = true;
+    PickId hovered_pick_ = PickBuffer::kNone;
+    PixelCoord picked_at_ = {-1.0f, -1.0f};  // mouse position hovered_pick_ was read at
+
+    // Scratch buffers for batch coordinate transforms
+    std::vector<float> tile_center_x_;
+    std::vector<float> tile_center_y_;
+    std::vector<float> tile_screen_x_;
+    std::vector<float> tile_screen_y_;
+    std::vector<float> npc_screen_x_;
+    std::vector<float> npc_screen_y_;
+    std::vector<float> particle_screen_x_;
+    std::vector<float> particle_screen_y_;
 
     SDL_Texture* grass_texture_ = nullptr;
     SDL_Texture* dirt_texture_ = nullptr;
     SDL_Texture* stone_texture_ = nullptr;
+    std::array<JobHandle, kTextureFiles.size()> texture_jobs_;
+    std::array<SDL_Surface*, kTextureFiles.size()> decoded_textures_ = {};
 };
 
 }  // namespace eerium
\ No newline at end of file
@@ -0,0 +1,242 @@
+#include "JobSystem.hpp"
+
+namespace eerium
+{
+
+namespace
+{
+
+// Which queue the current thread owns; threads that are not workers have none
+thread_local const JobSystem* tls_owner = nullptr;
+thread_local size_t tls_queue = 0;
+
+}  // namespace
+
+JobSystem::JobSystem(unsigned thread_count)
+{
+    if (thread_count == 0)
+    {
+        // The game loop joins in while it waits, so leave its core free
+        unsigned cores = std::thread::hardware_concurrency();
+        thread_count = cores > 1 ? cores - 1 : 1u;
+    }
+
+    for (unsigned i = 0; i <= thread_count; ++i)
+    {
+        queues_.push_back(std::make_unique<WorkQueue>());
+    }
+
+    workers_.reserve(thread_count);
+    for (unsigned i = 0; i < thread_count; ++i)
+    {
+        workers_.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+JobHandle JobSystem::Schedule(std::function<void()> function, std::span<const JobHandle> dependencies)
+{
+    auto job = std::make_shared<Job>();
+    job->function_ = std::move(function);
+
+    for (const JobHandle& dependency : dependencies)
+    {
+        if (!dependency)
+        {
+            continue;
+        }
+        std::lock_guard lock(dependency->mutex_);
+        if (!dependency->done_.load(std::memory_order_relaxed))
+        {
+            job->pending_.fetch_add(1, std::memory_order_relaxed);
+            dependency->dependents_.push_back(job);
+        }
+    }
+
+    // Drop the scheduling reference; the last finished dependency enqueues otherwise
+    if (job->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        Enqueue(job);
+    }
+    return job;
+}
+
+JobHandle JobSystem::ScheduleFrameJob(std::function<void()> function, std::span<const JobHandle> dependencies)
+{
+    JobHandle job = Schedule(std::move(function), dependencies);
+    std::lock_guard lock(frame_mutex_);
+    frame_jobs_.push_back(job);
+    return job;
+}
+
+void JobSystem::SyncFrame()
+{
+    std::vector<JobHandle> jobs;
+    {
+        std::lock_guard lock(frame_mutex_);
+        jobs.swap(frame_jobs_);
+    }
+    Wait(jobs);
+}
+
+void JobSystem::Wait(const JobHandle& job)
+{
+    while (job && !job->IsDone())
+    {
+        if (RunOne())
+        {
+            continue;
+        }
+
+        // Nothing to help with: the job is running elsewhere or waiting on one that is
+        std::unique_lock lock(sleep_mutex_);
+        sleepers_.fetch_add(1);
+        wake_.wait(lock, [&]
+                   { return job->IsDone() || queued_.load() > 0; });
+        sleepers_.fetch_sub(1);
+    }
+}
+
+void JobSystem::Wait(std::span<const JobHandle> jobs)
+{
+    for (const JobHandle& job : jobs)
+    {
+        Wait(job);
+    }
+}
+
+size_t JobSystem::OwnQueue() const
+{
+    return tls_owner == this ? tls_queue : queues_.size() - 1;
+}
+
+void JobSystem::Enqueue(JobHandle job)
+{
+    WorkQueue& queue = *queues_[OwnQueue()];
+    {
+        std::lock_guard lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+        queued_.fetch_add(1);
+    }
+    WakeSleepers();
+}
+
+JobHandle JobSystem::TakeJob()
+{
+    if (queued_.load() == 0)
+    {
+        return nullptr;
+    }
+
+    // Newest job of our own queue first, it is the most likely to be in cache
+    const size_t own = OwnQueue();
+    {
+        WorkQueue& queue = *queues_[own];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.jobs.empty())
+        {
+            JobHandle job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            queued_.fetch_sub(1);
+            return job;
+        }
+    }
+
+    // Then steal the oldest job of another queue
+    for (size_t i = 1; i < queues_.size(); ++i)
+    {
+        WorkQueue& queue = *queues_[(own + i) % queues_.size()];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.jobs.empty())
+        {
+            JobHandle job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            queued_.fetch_sub(1);
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+bool JobSystem::RunOne()
+{
+    JobHandle job = TakeJob();
+    if (!job)
+    {
+        return false;
+    }
+    Execute(job);
+    return true;
+}
+
+void JobSystem::Execute(const JobHandle& job)
+{
+    job->function_();
+    job->function_ = nullptr;
+
+    std::vector<JobHandle> dependents;
+    {
+        std::lock_guard lock(job->mutex_);
+        job->done_.store(true);  // ordered before the sleepers_ load in WakeSleepers()
+        dependents.swap(job->dependents_);
+    }
+    for (JobHandle& dependent : dependents)
+    {
+        if (dependent->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            Enqueue(std::move(dependent));
+        }
+    }
+    WakeSleepers();
+}
+
+void JobSystem::WakeSleepers()
+{
+    if (sleepers_.load() == 0)
+    {
+        return;
+    }
+    // Taking the lock orders this with a sleeper that checked its condition but is not waiting yet
+    {
+        std::lock_guard lock(sleep_mutex_);
+    }
+    wake_.notify_all();
+}
+
+void JobSystem::WorkerLoop(size_t index)
+{
+    tls_owner = this;
+    tls_queue = index;
+
+    while (true)
+    {
+        if (RunOne())
+        {
+            continue;
+        }
+
+        std::unique_lock lock(sleep_mutex_);
+        sleepers_.fetch_add(1);
+        wake_.wait(lock, [this]
+                   { return stopping_ || queued_.load() > 0; });
+        sleepers_.fetch_sub(1);
+        if (stopping_)
+        {
+            return;
+        }
+    }
+}
+
+}  // namespace eerium
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace eerium
+{
+
+/**
+ * A unit of work scheduled on a JobSystem. Keep the handle to wait for the
+ * job or to make other jobs depend on it.
+ */
+class Job
+{
+public:
+    // Sequentially consistent, like the store: a waiter that announced itself in
+    // sleepers_ then either sees the job done or is seen by WakeSleepers()
+    bool IsDone() const { return done_.load(); }
+
+private:
+    friend class JobSystem;
+
+    std::function<void()> function_;
+    std::atomic<uint32_t> pending_{1};  // unfinished dependencies, plus one while being scheduled
+    std::atomic<bool> done_{false};
+    std::mutex mutex_;                  // guards dependents_ against the job finishing meanwhile
+    std::vector<std::shared_ptr<Job>> dependents_;
+};
+
+using JobHandle = std::shared_ptr<Job>;
+
+/**
+ * Work-stealing thread pool shared by everything that wants more than one core.
+ *
+ * Every worker owns a queue: it pushes and pops its own jobs at the back and,
+ * when that runs dry, steals from the front of the others. Threads that are not
+ * workers (the game loop) share one extra queue. Jobs may depend on other jobs
+ * and only become runnable once all of them finished. Waiting never blocks
+ * while work is available; the waiting thread runs queued jobs instead.
+ *
+ * Frame jobs are regular jobs that are additionally collected until the next
+ * SyncFrame(), which is the point in the game loop where their results are
+ * consumed. Jobs must not throw.
+ */
+class JobSystem
+{
+public:
+    // thread_count 0 picks a count based on the available cores
+    explicit JobSystem(unsigned thread_count = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    size_t GetWorkerCount() const { return workers_.size(); }
+
+    /**
+     * @brief Schedule a job
+     * @param dependencies Jobs that have to finish before this one starts
+     */
+    JobHandle Schedule(std::function<void()> function, std::span<const JobHandle> dependencies = {});
+
+    // Schedule a job that the next SyncFrame() waits for
+    JobHandle ScheduleFrameJob(std::function<void()> function, std::span<const JobHandle> dependencies = {});
+
+    // Wait for all frame jobs scheduled so far
+    void SyncFrame();
+
+    // Block until the job(s) finished, running other jobs meanwhile
+    void Wait(const JobHandle& job);
+    void Wait(std::span<const JobHandle> jobs);
+
+    /**
+     * @brief Run fn(begin, end) over [0, count) in chunks of `grain` and wait for all of them
+     *
+     * The calling thread works on the chunks too, but never picks up unrelated
+     * jobs while it waits, so this is safe to call while holding a lock that
+     * other jobs take. Small ranges run inline.
+     */
+    template <typename Fn>
+    void ParallelFor(size_t count, size_t grain, Fn&& fn)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        grain = std::max<size_t>(grain, 1);
+        const size_t chunks = (count + grain - 1) / grain;
+        if (chunks == 1 || workers_.empty())
+        {
+            fn(size_t{0}, count);
+            return;
+        }
+
+        // Chunks are handed out through a shared counter, so faster threads take
+        // more of them. Helpers that only start once every chunk is taken find
+        // nothing left to do, which is why the counters outlive this call.
+        struct LoopState
+        {
+            std::atomic<size_t> next_chunk{0};
+            std::atomic<size_t> finished_chunks{0};
+        };
+        auto state = std::make_shared<LoopState>();
+        auto run_chunks = [state, chunks, grain, count, &fn]
+        {
+            for (size_t chunk = state->next_chunk.fetch_add(1); chunk < chunks; chunk = state->next_chunk.fetch_add(1))
+            {
+                const size_t begin = chunk * grain;
+                fn(begin, std::min(begin + grain, count));
+                if (state->finished_chunks.fetch_add(1) + 1 == chunks)
+                {
+                    state->finished_chunks.notify_all();
+                }
+            }
+        };
+
+        const size_t helpers = std::min(chunks - 1, workers_.size());
+        for (size_t i = 0; i < helpers; ++i)
+        {
+            Schedule(run_chunks);
+        }
+        run_chunks();
+
+        // Only chunks other threads are still working on remain
+        for (size_t finished = state->finished_chunks.load(); finished < chunks; finished = state->finished_chunks.load())
+        {
+            state->finished_chunks.wait(finished);
+        }
+    }
+
+private:
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<JobHandle> jobs;
+    };
+
+    size_t OwnQueue() const;
+    void Enqueue(JobHandle job);
+    JobHandle TakeJob();
+    bool RunOne();
+    void Execute(const JobHandle& job);
+    void WakeSleepers();
+    void WorkerLoop(size_t index);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;  // one per worker, the last one for other threads
+    std::vector<std::thread> workers_;
+
+    // Idle threads sleep here until a job is queued or finished
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<size_t> queued_{0};
+    std::atomic<size_t> sleepers_{0};
+    bool stopping_ = false;
+
+    std::mutex frame_mutex_;
+    std::vector<JobHandle> frame_jobs_;
+};
+
+}  // namespace eerium
@@ -35,6 +35,12 @@ void MainMenu::Reset()
 {
     selected_option_ = 0;
     action_selected_ = false;
+    new_options_.MarkDirty();
+}
+
+bool MainMenu::IsDirty() const
+{
+    return new_options_.IsDirty();
 }
 
 void MainMenu::HandleEvent(const SDL_Event& event)
@@ -54,6 +60,7 @@ void MainMenu::Render(sdl::Renderer& renderer)
     }
 
     auto window = renderer.GetWindowSize();
+    renderer.Commands().SetLayer(sdl::CommandBuffer::kLayerUi);
 
     // Render title
     renderer.RenderText("EERIUM", window.width / 2, 100, sdl::kColorRed, *title_font_, sdl::Renderer::TextAlign::CENTER);
@@ -31,6 +31,9 @@ public:
     void Render(sdl::Renderer& renderer);
     Item GetActivatedItem() const;
 
+    // True when the menu needs to be redrawn
+    bool IsDirty() const;
+
 private:
     std::array<Item, 3> options_ = {
         Item{.name = "start", .label = "Start Game"},
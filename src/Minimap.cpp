@@ -0,0 +1,55 @@
+#include "Minimap.hpp"
+
+namespace eerium
+{
+
+Minimap::Minimap(int width, int height) : width_(width), height_(height), tiles_(width, height, sdl::kColorBlack) {}
+
+void Minimap::SetLayout(float top_x, float top_y, float width, float aspect_ratio)
+{
+    top_ = {top_x, top_y};
+    right_step_ = {width / 2.0f / width_, width * aspect_ratio / 2.0f / width_};
+    down_step_ = {-width / 2.0f / height_, width * aspect_ratio / 2.0f / height_};
+}
+
+SDL_FPoint Minimap::TileToMinimap(float x, float y) const
+{
+    // Tile x covers texture pixel x, so its center is half a pixel in
+    const float u = x + 0.5f;
+    const float v = y + 0.5f;
+    return {top_.x + u * right_step_.x + v * down_step_.x, top_.y + u * right_step_.y + v * down_step_.y};
+}
+
+void Minimap::Render(SDL_Renderer* renderer, sdl::CommandBuffer& commands, SDL_FPoint player,
+                     std::span<const SDL_FPoint, 4> view)
+{
+    SDL_Texture* texture = tiles_.Get(renderer);
+
+    // The texture corners become the corners of the diamond
+    const SDL_FColor white = {1.0f, 1.0f, 1.0f, 1.0f};
+    const SDL_FPoint right = {top_.x + width_ * right_step_.x, top_.y + width_ * right_step_.y};
+    const SDL_FPoint left = {top_.x + height_ * down_step_.x, top_.y + height_ * down_step_.y};
+    const SDL_FPoint bottom = {right.x + height_ * down_step_.x, right.y + height_ * down_step_.y};
+    SDL_Vertex diamond[4] = {
+        {top_, white, {0.0f, 0.0f}},
+        {right, white, {1.0f, 0.0f}},
+        {bottom, white, {1.0f, 1.0f}},
+        {left, white, {0.0f, 1.0f}},
+    };
+    int indices[] = {0, 1, 2, 0, 2, 3};
+    commands.Geometry(texture, diamond, indices);
+
+    // What the window shows, then the player on top
+    SDL_FPoint outline[5];
+    for (size_t i = 0; i < 4; ++i)
+    {
+        outline[i] = TileToMinimap(view[i].x, view[i].y);
+    }
+    outline[4] = outline[0];
+    commands.Lines(outline, {255, 255, 255, 200});
+
+    SDL_FPoint marker = TileToMinimap(player.x, player.y);
+    commands.FillRect({marker.x - 2.0f, marker.y - 2.0f, 4.0f, 4.0f}, sdl::kColorMagenta);
+}
+
+}  // namespace eerium
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <span>
+
+#include "TileTexture.hpp"
+#include "sdl/Color.hpp"
+#include "sdl/CommandBuffer.hpp"
+
+namespace eerium
+{
+
+/**
+ * Overview of the whole map, one texture pixel per tile, see TileTexture.
+ *
+ * A frame costs one quad plus the upload of whatever was edited. The texture
+ * is drawn as a diamond in the same orientation as the isometric view.
+ */
+class Minimap
+{
+public:
+    Minimap(int width, int height);
+
+    void SetTile(int x, int y, sdl::Color color) { tiles_.SetTile(x, y, color); }
+
+    // The tile colors, also used to draw far zoomed out terrain
+    SDL_Texture* GetTexture(SDL_Renderer* renderer) { return tiles_.Get(renderer); }
+
+    // Place the diamond: top corner and full width; the height follows the tile aspect ratio
+    void SetLayout(float top_x, float top_y, float width, float aspect_ratio);
+
+    // Screen position of a tile position on the minimap
+    SDL_FPoint TileToMinimap(float x, float y) const;
+
+    /**
+     * Upload the changed chunks and record the map with its markers.
+     * @param player Tile position of the player
+     * @param view Tile positions of the window corners, in drawing order
+     */
+    void Render(SDL_Renderer* renderer, sdl::CommandBuffer& commands, SDL_FPoint player,
+                std::span<const SDL_FPoint, 4> view);
+
+private:
+    int width_;
+    int height_;
+    TileTexture tiles_;
+
+    SDL_FPoint top_ = {0.0f, 0.0f};
+    SDL_FPoint right_step_ = {0.0f, 0.0f};  // screen step per tile along x
+    SDL_FPoint down_step_ = {0.0f, 0.0f};   // screen step per tile along y
+};
+
+}  // namespace eerium
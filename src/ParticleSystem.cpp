@@ -0,0 +1,183 @@
+#include "ParticleSystem.hpp"
+
+#include <algorithm>
+
+#include "Simd.hpp"
+
+namespace eerium
+{
+
+ParticleSystem::ParticleSystem(size_t capacity)
+    : capacity_(capacity),
+      pos_x_(capacity),
+      pos_y_(capacity),
+      pos_z_(capacity),
+      velocity_x_(capacity),
+      velocity_y_(capacity),
+      velocity_z_(capacity),
+      gravity_(capacity),
+      life_(capacity),
+      inverse_lifetime_(capacity),
+      size_(capacity),
+      color_(capacity)
+{
+    vertices_.resize(capacity * 4);
+    indices_.resize(capacity * 6);
+    for (size_t i = 0; i < capacity; ++i)
+    {
+        const int base = static_cast<int>(i * 4);
+        const int quad[] = {base, base + 1, base + 2, base, base + 2, base + 3};
+        std::copy(std::begin(quad), std::end(quad), indices_.begin() + static_cast<std::ptrdiff_t>(i * 6));
+    }
+}
+
+bool ParticleSystem::Spawn(const ParticleSpawn& spawn)
+{
+    if (count_ == capacity_ || spawn.lifetime <= 0.0f)
+    {
+        return false;
+    }
+
+    size_t i = count_++;
+    pos_x_[i] = spawn.x;
+    pos_y_[i] = spawn.y;
+    pos_z_[i] = spawn.z;
+    velocity_x_[i] = spawn.velocity_x;
+    velocity_y_[i] = spawn.velocity_y;
+    velocity_z_[i] = spawn.velocity_z;
+    gravity_[i] = spawn.gravity;
+    life_[i] = spawn.lifetime;
+    inverse_lifetime_[i] = 1.0f / spawn.lifetime;
+    size_[i] = spawn.size;
+    color_[i] = spawn.color;
+    return true;
+}
+
+void ParticleSystem::MoveParticle(size_t from, size_t to)
+{
+    pos_x_[to] = pos_x_[from];
+    pos_y_[to] = pos_y_[from];
+    pos_z_[to] = pos_z_[from];
+    velocity_x_[to] = velocity_x_[from];
+    velocity_y_[to] = velocity_y_[from];
+    velocity_z_[to] = velocity_z_[from];
+    gravity_[to] = gravity_[from];
+    life_[to] = life_[from];
+    inverse_lifetime_[to] = inverse_lifetime_[from];
+    size_[to] = size_[from];
+    color_[to] = color_[from];
+}
+
+void ParticleSystem::Update(float dt)
+{
+    size_t tail = IntegrateSimd(0, count_, dt);
+    IntegrateScalar(tail, count_, dt);
+
+    // Fill the holes of the dead with the last live particles
+    size_t i = 0;
+    while (i < count_)
+    {
+        if (life_[i] > 0.0f)
+        {
+            ++i;
+            continue;
+        }
+        --count_;
+        if (i != count_)
+        {
+            MoveParticle(count_, i);
+        }
+    }
+}
+
+void ParticleSystem::IntegrateScalar(size_t begin, size_t end, float dt)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        velocity_z_[i] += gravity_[i] * dt;
+        pos_x_[i] += velocity_x_[i] * dt;
+        pos_y_[i] += velocity_y_[i] * dt;
+        pos_z_[i] += velocity_z_[i] * dt;
+        life_[i] = pos_z_[i] < 0.0f ? 0.0f : life_[i] - dt;
+    }
+}
+
+// Same math as IntegrateScalar(); the ground test becomes a mask that zeroes the life
+size_t ParticleSystem::IntegrateSimd(size_t begin, size_t end, float dt)
+{
+    size_t i = begin;
+    float* px = pos_x_.data();
+    float* py = pos_y_.data();
+    float* pz = pos_z_.data();
+    const float* vx = velocity_x_.data();
+    const float* vy = velocity_y_.data();
+    float* vz = velocity_z_.data();
+    const float* gravity = gravity_.data();
+    float* life = life_.data();
+
+#if defined(EERIUM_SIMD_AVX2)
+    const __m256 dt_v = _mm256_set1_ps(dt);
+    const __m256 zero = _mm256_setzero_ps();
+    for (; i + 8 <= end; i += 8)
+    {
+        __m256 velocity_z = _mm256_fmadd_ps(_mm256_loadu_ps(gravity + i), dt_v, _mm256_loadu_ps(vz + i));
+        __m256 z = _mm256_fmadd_ps(velocity_z, dt_v, _mm256_loadu_ps(pz + i));
+        _mm256_storeu_ps(vz + i, velocity_z);
+        _mm256_storeu_ps(pz + i, z);
+        _mm256_storeu_ps(px + i, _mm256_fmadd_ps(_mm256_loadu_ps(vx + i), dt_v, _mm256_loadu_ps(px + i)));
+        _mm256_storeu_ps(py + i, _mm256_fmadd_ps(_mm256_loadu_ps(vy + i), dt_v, _mm256_loadu_ps(py + i)));
+
+        __m256 above = _mm256_cmp_ps(z, zero, _CMP_GE_OQ);
+        _mm256_storeu_ps(life + i, _mm256_and_ps(above, _mm256_sub_ps(_mm256_loadu_ps(life + i), dt_v)));
+    }
+#elif defined(EERIUM_SIMD_SSE2)
+    const __m128 dt_v = _mm_set1_ps(dt);
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 velocity_z = _mm_add_ps(_mm_loadu_ps(vz + i), _mm_mul_ps(_mm_loadu_ps(gravity + i), dt_v));
+        __m128 z = _mm_add_ps(_mm_loadu_ps(pz + i), _mm_mul_ps(velocity_z, dt_v));
+        _mm_storeu_ps(vz + i, velocity_z);
+        _mm_storeu_ps(pz + i, z);
+        _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(_mm_loadu_ps(vx + i), dt_v)));
+        _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(_mm_loadu_ps(vy + i), dt_v)));
+
+        __m128 above = _mm_cmpge_ps(z, zero);
+        _mm_storeu_ps(life + i, _mm_and_ps(above, _mm_sub_ps(_mm_loadu_ps(life + i), dt_v)));
+    }
+#endif
+
+    return i;
+}
+
+void ParticleSystem::Render(sdl::CommandBuffer& commands, SDL_Texture* texture, std::span<const float> screen_x,
+                            std::span<const float> screen_y, float height_scale, float size_scale,
+                            const SDL_FRect& area)
+{
+    size_t quads = 0;
+    SDL_Vertex* vertex = vertices_.data();
+    for (size_t i = 0; i < count_; ++i)
+    {
+        const float half = size_[i] * size_scale * 0.5f;
+        const float x = screen_x[i];
+        const float y = screen_y[i] - pos_z_[i] * height_scale;
+        if (x + half < area.x || x - half > area.x + area.w || y + half < area.y || y - half > area.y + area.h)
+        {
+            continue;
+        }
+
+        const sdl::Color color = color_[i];
+        const float fade = std::min(1.0f, life_[i] * inverse_lifetime_[i] * 2.0f);  // fade over the second half
+        const SDL_FColor tint = {color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f * fade};
+        vertex[0] = {{x - half, y - half}, tint, {0.0f, 0.0f}};
+        vertex[1] = {{x + half, y - half}, tint, {1.0f, 0.0f}};
+        vertex[2] = {{x + half, y + half}, tint, {1.0f, 1.0f}};
+        vertex[3] = {{x - half, y + half}, tint, {0.0f, 1.0f}};
+        vertex += 4;
+        ++quads;
+    }
+
+    commands.Geometry(texture, std::span(vertices_.data(), quads * 4), std::span(indices_.data(), quads * 6));
+}
+
+}  // namespace eerium
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "sdl/Color.hpp"
+#include "sdl/CommandBuffer.hpp"
+
+namespace eerium
+{
+
+// Initial state of one particle; positions are in tiles, heights in tile heights above the ground
+struct ParticleSpawn
+{
+    float x;
+    float y;
+    float z;
+    float velocity_x;
+    float velocity_y;
+    float velocity_z;
+    float gravity;   // added to velocity_z every second, negative pulls down
+    float lifetime;  // seconds
+    float size;      // pixels at the default zoom
+    sdl::Color color;
+};
+
+/**
+ * Fixed-capacity pool of short-lived particles for weather, dust and spells.
+ *
+ * Every particle attribute is a dense column of `capacity` entries that is
+ * allocated once, so spawning and dying never allocate: the live particles
+ * are the first Size() entries and a dead one is replaced by the last live
+ * one. Integration runs as one SIMD batch over the columns. A particle dies
+ * when its lifetime runs out or it falls through the ground.
+ *
+ * Render() turns all live particles into quads of one texture and records
+ * them as a single geometry command.
+ */
+class ParticleSystem
+{
+public:
+    static constexpr size_t kDefaultCapacity = 100000;
+
+    explicit ParticleSystem(size_t capacity = kDefaultCapacity);
+
+    // Add a particle, dropped if the pool is full
+    bool Spawn(const ParticleSpawn& spawn);
+    void Clear() { count_ = 0; }
+
+    size_t Size() const { return count_; }
+    size_t Capacity() const { return capacity_; }
+
+    // Shared random source for emitters; effects are cosmetic, so this is not the game's generator
+    std::minstd_rand& Random() { return random_; }
+
+    // Advance every particle by dt seconds and drop the dead ones
+    void Update(float dt);
+
+    // Live ground positions, for transforming them to the screen in one batch
+    std::span<const float> PositionsX() const { return {pos_x_.data(), count_}; }
+    std::span<const float> PositionsY() const { return {pos_y_.data(), count_}; }
+
+    /**
+     * Record every live particle as a quad of `texture`.
+     * @param screen_x, screen_y Ground positions on screen, as transformed from PositionsX/Y()
+     * @param height_scale Pixels per tile height
+     * @param size_scale Factor for the particle sizes, e.g. the current zoom
+     * @param area Particles outside of this screen area are skipped
+     */
+    void Render(sdl::CommandBuffer& commands, SDL_Texture* texture, std::span<const float> screen_x,
+                std::span<const float> screen_y, float height_scale, float size_scale, const SDL_FRect& area);
+
+private:
+    // Batch kernels over [begin, end); the SIMD one returns where the scalar tail starts
+    void IntegrateScalar(size_t begin, size_t end, float dt);
+    size_t IntegrateSimd(size_t begin, size_t end, float dt);
+
+    // Move particle `from` into slot `to`
+    void MoveParticle(size_t from, size_t to);
+
+    size_t capacity_;
+    size_t count_ = 0;
+    std::minstd_rand random_;
+
+    std::vector<float> pos_x_;
+    std::vector<float> pos_y_;
+    std::vector<float> pos_z_;
+    std::vector<float> velocity_x_;
+    std::vector<float> velocity_y_;
+    std::vector<float> velocity_z_;
+    std::vector<float> gravity_;
+    std::vector<float> life_;              // seconds left
+    std::vector<float> inverse_lifetime_;  // fades the alpha as life runs out
+    std::vector<float> size_;
+    std::vector<sdl::Color> color_;
+
+    // Output geometry; the index pattern never changes, so it is built once
+    std::vector<SDL_Vertex> vertices_;
+    std::vector<int> indices_;
+};
+
+}  // namespace eerium
@@ -0,0 +1,363 @@
+#include "Pathfinder.hpp"
+
+#include "FlowField.hpp"
+#include "HierarchicalPathfinder.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+
+namespace eerium
+{
+
+CostGrid CostGrid::FromTileMap(const TileMap& map)
+{
+    CostGrid grid;
+    grid.width = map.GetWidth();
+    grid.height = map.GetHeight();
+    grid.cost.reserve(map.GetTiles().size());
+
+    uint8_t min_cost = 0;
+    for (const Tile& tile : map.GetTiles())
+    {
+        uint8_t cost = TileMoveCost(tile);
+        grid.cost.push_back(cost);
+        if (cost != 0 && (min_cost == 0 || cost < min_cost))
+        {
+            min_cost = cost;
+        }
+    }
+    grid.min_cost = min_cost != 0 ? min_cost : 1;
+    return grid;
+}
+
+uint32_t AStarSearch::Heuristic(const CostGrid& grid, int x, int y, GridPoint goal) const
+{
+    // Octile distance at the cheapest tile cost
+    uint32_t dx = static_cast<uint32_t>(std::abs(x - goal.x));
+    uint32_t dy = static_cast<uint32_t>(std::abs(y - goal.y));
+    uint32_t diagonal = std::min(dx, dy);
+    uint32_t straight = std::max(dx, dy) - diagonal;
+    return grid.min_cost * (kDiagonalStep * diagonal + kStraightStep * straight);
+}
+
+namespace
+{
+
+constexpr int kDirections[8][2] = {
+    {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+// Whether a step from (x, y) by `direction` stays in bounds and does not cut a blocked corner
+bool CanStep(const CostGrid& grid, const SearchBounds& bounds, int x, int y, const int* direction)
+{
+    const int nx = x + direction[0];
+    const int ny = y + direction[1];
+    if (!bounds.Contains(nx, ny) || !grid.IsWalkable(nx, ny))
+    {
+        return false;
+    }
+    if (direction[0] != 0 && direction[1] != 0)
+    {
+        return grid.IsWalkable(nx, y) && grid.IsWalkable(x, ny);
+    }
+    return true;
+}
+
+uint32_t StepCost(const CostGrid& grid, int to_x, int to_y, const int* direction)
+{
+    const bool diagonal = direction[0] != 0 && direction[1] != 0;
+    return grid.At(to_x, to_y) * (diagonal ? AStarSearch::kDiagonalStep : AStarSearch::kStraightStep);
+}
+
+}  // namespace
+
+void AStarSearch::BeginSearch(size_t node_count)
+{
+    // Buffers only grow; entries beyond the old size start with stamp 0
+    if (stamp_.size() < node_count)
+    {
+        g_.resize(node_count);
+        parent_.resize(node_count);
+        stamp_.resize(node_count, 0);
+    }
+    if (++generation_ == 0)
+    {
+        // Wrapped around, old stamps could look current again
+        std::fill(stamp_.begin(), stamp_.end(), 0);
+        generation_ = 1;
+    }
+    open_.clear();
+}
+
+bool AStarSearch::FindPath(const CostGrid& grid, GridPoint start, GridPoint goal, std::vector<GridPoint>& path)
+{
+    return FindPath(grid, start, goal, SearchBounds::Of(grid), path);
+}
+
+bool AStarSearch::FindPath(const CostGrid& grid, GridPoint start, GridPoint goal, const SearchBounds& bounds,
+                           std::vector<GridPoint>& path)
+{
+    path.clear();
+    if (!bounds.Contains(start.x, start.y) || !bounds.Contains(goal.x, goal.y) ||
+        !grid.InBounds(start.x, start.y) || !grid.IsWalkable(goal.x, goal.y))
+    {
+        return false;
+    }
+    if (start == goal)
+    {
+        return true;
+    }
+
+    // Nodes are indexed relative to the window
+    const uint32_t width = static_cast<uint32_t>(bounds.Width());
+    auto to_node = [&](int x, int y)
+    { return static_cast<uint32_t>(y - bounds.min_y) * width + static_cast<uint32_t>(x - bounds.min_x); };
+
+    BeginSearch(static_cast<size_t>(bounds.Width()) * bounds.Height());
+
+    auto greater_f = [](const OpenNode& a, const OpenNode& b)
+    { return a.f > b.f; };
+    auto push = [&](uint32_t node, uint32_t f)
+    {
+        open_.push_back({f, node});
+        std::push_heap(open_.begin(), open_.end(), greater_f);
+    };
+
+    const uint32_t start_node = to_node(start.x, start.y);
+    const uint32_t goal_node = to_node(goal.x, goal.y);
+
+    g_[start_node] = 0;
+    parent_[start_node] = start_node;
+    stamp_[start_node] = generation_;
+    push(start_node, Heuristic(grid, start.x, start.y, goal));
+
+    while (!open_.empty())
+    {
+        std::pop_heap(open_.begin(), open_.end(), greater_f);
+        OpenNode current = open_.back();
+        open_.pop_back();
+
+        const uint32_t node = current.node;
+        const int x = bounds.min_x + static_cast<int>(node % width);
+        const int y = bounds.min_y + static_cast<int>(node / width);
+
+        // Skip stale heap entries superseded by a cheaper path
+        if (current.f > g_[node] + Heuristic(grid, x, y, goal))
+        {
+            continue;
+        }
+
+        if (node == goal_node)
+        {
+            for (uint32_t step = goal_node; step != start_node; step = parent_[step])
+            {
+                path.push_back({bounds.min_x + static_cast<int>(step % width), bounds.min_y + static_cast<int>(step / width)});
+            }
+            std::reverse(path.begin(), path.end());
+            return true;
+        }
+
+        for (const auto& direction : kDirections)
+        {
+            if (!CanStep(grid, bounds, x, y, direction))
+            {
+                continue;
+            }
+
+            const int nx = x + direction[0];
+            const int ny = y + direction[1];
+            const uint32_t neighbor = to_node(nx, ny);
+            const uint32_t new_g = g_[node] + StepCost(grid, nx, ny, direction);
+            if (stamp_[neighbor] != generation_ || new_g < g_[neighbor])
+            {
+                stamp_[neighbor] = generation_;
+                g_[neighbor] = new_g;
+                parent_[neighbor] = node;
+                push(neighbor, new_g + Heuristic(grid, nx, ny, goal));
+            }
+        }
+    }
+
+    return false;
+}
+
+void AStarSearch::ComputeCosts(const CostGrid& grid, GridPoint origin, const SearchBounds& bounds, bool reverse,
+                               std::vector<uint32_t>& costs)
+{
+    const uint32_t width = static_cast<uint32_t>(bounds.Width());
+    const size_t node_count = static_cast<size_t>(bounds.Width()) * bounds.Height();
+    costs.assign(node_count, kUnreachable);
+    if (!bounds.Contains(origin.x, origin.y) || !grid.InBounds(origin.x, origin.y))
+    {
+        return;
+    }
+
+    // Plain Dijkstra; the heap key is the cost itself
+    auto greater_f = [](const OpenNode& a, const OpenNode& b)
+    { return a.f > b.f; };
+    open_.clear();
+
+    const uint32_t origin_node = static_cast<uint32_t>(origin.y - bounds.min_y) * width + (origin.x - bounds.min_x);
+    costs[origin_node] = 0;
+    open_.push_back({0, origin_node});
+
+    while (!open_.empty())
+    {
+        std::pop_heap(open_.begin(), open_.end(), greater_f);
+        OpenNode current = open_.back();
+        open_.pop_back();
+
+        const uint32_t node = current.node;
+        if (current.f > costs[node])
+        {
+            continue;
+        }
+        const int x = bounds.min_x + static_cast<int>(node % width);
+        const int y = bounds.min_y + static_cast<int>(node / width);
+
+        for (const auto& direction : kDirections)
+        {
+            if (!CanStep(grid, bounds, x, y, direction))
+            {
+                continue;
+            }
+
+            // Forward: entering the neighbor costs its tile. Reverse: the path runs
+            // neighbor -> current, which costs entering the current tile.
+            const int nx = x + direction[0];
+            const int ny = y + direction[1];
+            const uint32_t step = reverse ? StepCost(grid, x, y, direction) : StepCost(grid, nx, ny, direction);
+            const uint32_t neighbor = static_cast<uint32_t>(ny - bounds.min_y) * width + (nx - bounds.min_x);
+            const uint32_t new_cost = current.f + step;
+            if (new_cost < costs[neighbor])
+            {
+                costs[neighbor] = new_cost;
+                open_.push_back({new_cost, neighbor});
+                std::push_heap(open_.begin(), open_.end(), greater_f);
+            }
+        }
+    }
+}
+
+Pathfinder::Pathfinder(JobSystem& jobs)
+    : jobs_(jobs),
+      hierarchy_(std::make_unique<HierarchicalPathfinder>())
+{
+}
+
+Pathfinder::~Pathfinder()
+{
+    // Jobs still in flight write into this object
+    WaitAll();
+}
+
+void Pathfinder::SetGrid(const CostGrid& grid)
+{
+    // The hierarchy has its own lock, queries wait for the rebuild to finish
+    hierarchy_->Build(grid, &jobs_);
+}
+
+void Pathfinder::UpdateTiles(std::span<const TileCostChange> changes)
+{
+    hierarchy_->UpdateTiles(changes, &jobs_);
+}
+
+PathRequestId Pathfinder::NextId()
+{
+    PathRequestId id = next_id_++;
+    if (next_id_ == kNoPathRequest)
+    {
+        next_id_ = 1;
+    }
+    return id;
+}
+
+PathRequestId Pathfinder::Request(GridPoint start, GridPoint goal)
+{
+    std::lock_guard lock(mutex_);
+    PathRequestId id = NextId();
+    in_flight_.push_back(jobs_.Schedule([this, id, start, goal]
+                                        { SolvePath(id, start, goal); }));
+    return id;
+}
+
+PathRequestId Pathfinder::RequestFlowField(GridPoint target)
+{
+    std::lock_guard lock(mutex_);
+    PathRequestId id = NextId();
+    in_flight_.push_back(jobs_.Schedule([this, id, target]
+                                        { BuildFlowField(id, target); }));
+    return id;
+}
+
+void Pathfinder::SolvePath(PathRequestId id, GridPoint start, GridPoint goal)
+{
+    // Search buffers are per thread and reused by every query solved on it
+    static thread_local HierarchicalPathfinder::Scratch scratch;
+
+    PathResult result;
+    result.id = id;
+    result.found = hierarchy_->FindPath(start, goal, scratch, result.path);
+
+    std::lock_guard lock(mutex_);
+    finished_.push_back(std::move(result));
+}
+
+void Pathfinder::BuildFlowField(PathRequestId id, GridPoint target)
+{
+    static thread_local AStarSearch search;
+
+    auto field = std::make_shared<FlowField>();
+    hierarchy_->WithGrid([&](const CostGrid& grid)
+                         { field->Build(grid, target, search); });
+
+    FlowFieldResult result;
+    result.id = id;
+    result.field = std::move(field);
+
+    std::lock_guard lock(mutex_);
+    finished_fields_.push_back(std::move(result));
+}
+
+void Pathfinder::Poll(std::vector<PathResult>& results)
+{
+    std::lock_guard lock(mutex_);
+    std::erase_if(in_flight_, [](const JobHandle& job)
+                  { return job->IsDone(); });
+    if (finished_.empty())
+    {
+        return;
+    }
+    std::move(finished_.begin(), finished_.end(), std::back_inserter(results));
+    finished_.clear();
+}
+
+void Pathfinder::Poll(std::vector<FlowFieldResult>& results)
+{
+    std::lock_guard lock(mutex_);
+    if (finished_fields_.empty())
+    {
+        return;
+    }
+    std::move(finished_fields_.begin(), finished_fields_.end(), std::back_inserter(results));
+    finished_fields_.clear();
+}
+
+void Pathfinder::WaitAll()
+{
+    std::vector<JobHandle> in_flight;
+    {
+        std::lock_guard lock(mutex_);
+        in_flight = in_flight_;
+    }
+    jobs_.Wait(in_flight);
+}
+
+size_t Pathfinder::GetPendingCount() const
+{
+    std::lock_guard lock(mutex_);
+    return std::count_if(in_flight_.begin(), in_flight_.end(), [](const JobHandle& job)
+                         { return !job->IsDone(); });
+}
+
+}  // namespace eerium
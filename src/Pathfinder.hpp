@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "JobSystem.hpp"
+#include "TileMap.hpp"
+
+namespace eerium
+{
+
+class FlowField;
+class HierarchicalPathfinder;
+
+struct GridPoint
+{
+    int x = 0;
+    int y = 0;
+
+    bool operator==(const GridPoint&) const = default;
+};
+
+struct TileCostChange
+{
+    GridPoint tile;
+    uint8_t cost = 0;  // new TileMoveCost, 0 = blocked
+};
+
+/**
+ * Per-tile movement costs, built from a TileMap with TileMoveCost().
+ */
+struct CostGrid
+{
+    int width = 0;
+    int height = 0;
+    uint8_t min_cost = 1;       // cheapest walkable tile, keeps the heuristic admissible
+    std::vector<uint8_t> cost;  // 0 = blocked
+
+    static CostGrid FromTileMap(const TileMap& map);
+
+    bool InBounds(int x, int y) const { return x >= 0 && y >= 0 && x < width && y < height; }
+    uint8_t At(int x, int y) const { return cost[static_cast<size_t>(y) * width + x]; }
+    bool IsWalkable(int x, int y) const { return InBounds(x, y) && At(x, y) != 0; }
+};
+
+// Rectangle of tiles a search may visit: [min_x, max_x) x [min_y, max_y)
+struct SearchBounds
+{
+    int min_x = 0;
+    int min_y = 0;
+    int max_x = 0;
+    int max_y = 0;
+
+    static SearchBounds Of(const CostGrid& grid) { return {0, 0, grid.width, grid.height}; }
+
+    bool Contains(int x, int y) const { return x >= min_x && y >= min_y && x < max_x && y < max_y; }
+    int Width() const { return max_x - min_x; }
+    int Height() const { return max_y - min_y; }
+};
+
+/**
+ * A* over a CostGrid with 8-way movement.
+ *
+ * Diagonal steps cost 1.4x the entered tile and may not cut blocked corners.
+ * Searches can be limited to a window of the grid; the buffers are sized to
+ * the largest window seen, kept between queries and invalidated with a
+ * generation counter, so repeated searches neither reallocate nor clear the
+ * per-node arrays. One instance must not be used by two threads at once.
+ */
+class AStarSearch
+{
+public:
+    // Cost units of one straight / diagonal step onto a tile of cost 1
+    static constexpr uint32_t kStraightStep = 5;
+    static constexpr uint32_t kDiagonalStep = 7;
+    static constexpr uint32_t kUnreachable = UINT32_MAX;
+
+    /**
+     * @brief Find a path from start to goal
+     * @param path Receives the tiles after start, up to and including goal
+     * @return true if the goal is reachable
+     */
+    bool FindPath(const CostGrid& grid, GridPoint start, GridPoint goal, std::vector<GridPoint>& path);
+
+    /**
+     * @brief Find a path from start to goal without leaving bounds
+     */
+    bool FindPath(const CostGrid& grid, GridPoint start, GridPoint goal, const SearchBounds& bounds,
+                  std::vector<GridPoint>& path);
+
+    /**
+     * @brief Cost of the cheapest path between origin and every tile in bounds
+     * @param reverse false: cost from origin to each tile, true: cost from each tile to origin
+     * @param costs Receives one cost per tile of bounds, row-major, kUnreachable if none
+     */
+    void ComputeCosts(const CostGrid& grid, GridPoint origin, const SearchBounds& bounds, bool reverse,
+                      std::vector<uint32_t>& costs);
+
+private:
+    uint32_t Heuristic(const CostGrid& grid, int x, int y, GridPoint goal) const;
+    void BeginSearch(size_t node_count);
+
+    std::vector<uint32_t> g_;
+    std::vector<uint32_t> parent_;
+    std::vector<uint32_t> stamp_;  // node data is valid when stamp_ == generation_
+    uint32_t generation_ = 0;
+
+    struct OpenNode
+    {
+        uint32_t f;
+        uint32_t node;
+    };
+    std::vector<OpenNode> open_;
+};
+
+using PathRequestId = uint32_t;
+static constexpr PathRequestId kNoPathRequest = 0;
+
+struct PathResult
+{
+    PathRequestId id = kNoPathRequest;
+    bool found = false;
+    std::vector<GridPoint> path;  // tiles after the start, up to and including the goal
+};
+
+struct FlowFieldResult
+{
+    PathRequestId id = kNoPathRequest;
+    std::shared_ptr<const FlowField> field;  // shared by every unit heading to the target
+};
+
+/**
+ * Asynchronous path queries solved on the job system.
+ *
+ * Request() only schedules the query and returns immediately; finished
+ * results are collected on the calling thread with Poll(), typically once per
+ * fixed update, so large batches of requests never stall the game loop.
+ * Queries are answered by a HierarchicalPathfinder shared by all jobs.
+ */
+class Pathfinder
+{
+public:
+    explicit Pathfinder(JobSystem& jobs);
+    ~Pathfinder();
+
+    Pathfinder(const Pathfinder&) = delete;
+    Pathfinder& operator=(const Pathfinder&) = delete;
+
+    // Replace the whole grid; requests still in flight are solved against the new one
+    void SetGrid(const CostGrid& grid);
+
+    // Repair the search graph after individual tiles changed
+    void UpdateTiles(std::span<const TileCostChange> changes);
+
+    PathRequestId Request(GridPoint start, GridPoint goal);
+
+    // Flow field towards target, for many units moving to the same tile
+    PathRequestId RequestFlowField(GridPoint target);
+
+    // Append all results finished since the last call
+    void Poll(std::vector<PathResult>& results);
+    void Poll(std::vector<FlowFieldResult>& results);
+
+    // Block until every request made so far is solved; the results still have to be polled
+    void WaitAll();
+
+    // Requests that are queued or being solved
+    size_t GetPendingCount() const;
+
+private:
+    PathRequestId NextId();
+    void SolvePath(PathRequestId id, GridPoint start, GridPoint goal);
+    void BuildFlowField(PathRequestId id, GridPoint target);
+
+    JobSystem& jobs_;
+    std::unique_ptr<HierarchicalPathfinder> hierarchy_;
+
+    mutable std::mutex mutex_;
+    std::vector<JobHandle> in_flight_;
+    std::vector<PathResult> finished_;
+    std::vector<FlowFieldResult> finished_fields_;
+    PathRequestId next_id_ = 1;
+};
+
+}  // namespace eerium
@@ -0,0 +1,59 @@
+#include "PickBuffer.hpp"
+
+#include <cmath>
+
+namespace eerium
+{
+
+void PickBuffer::Begin(sdl::Renderer& renderer)
+{
+    auto window_size = renderer.GetWindowSize();
+    target_.Resize(renderer, static_cast<int>(std::ceil(window_size.width * scale_)),
+                   static_cast<int>(std::ceil(window_size.height * scale_)));
+
+    SDL_SetRenderTarget(renderer, target_);
+    SDL_SetRenderScale(renderer, scale_, scale_);
+
+    // Ids must not be blended with whatever is below them
+    SDL_GetRenderDrawBlendMode(renderer, &saved_blend_mode_);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+}
+
+void PickBuffer::End(sdl::Renderer& renderer)
+{
+    SDL_SetRenderDrawBlendMode(renderer, saved_blend_mode_);
+    SDL_SetRenderScale(renderer, 1.0f, 1.0f);
+    SDL_SetRenderTarget(renderer, nullptr);
+}
+
+PickId PickBuffer::Pick(sdl::Renderer& renderer, float x, float y)
+{
+    const int px = static_cast<int>(x * scale_);
+    const int py = static_cast<int>(y * scale_);
+    if (!target_.Get() || px < 0 || py < 0 || px >= target_.GetWidth() || py >= target_.GetHeight())
+    {
+        return kNone;
+    }
+
+    // Only the one pixel travels back from the GPU
+    SDL_SetRenderTarget(renderer, target_);
+    SDL_Rect rect = {px, py, 1, 1};
+    SDL_Surface* pixel = SDL_RenderReadPixels(renderer, &rect);
+    SDL_SetRenderTarget(renderer, nullptr);
+    if (!pixel)
+    {
+        return kNone;
+    }
+
+    Uint8 r = 0;
+    Uint8 g = 0;
+    Uint8 b = 0;
+    Uint8 a = 0;
+    SDL_ReadSurfacePixel(pixel, 0, 0, &r, &g, &b, &a);
+    SDL_DestroySurface(pixel);
+    return (static_cast<PickId>(r) << 16) | (static_cast<PickId>(g) << 8) | b;
+}
+
+}  // namespace eerium
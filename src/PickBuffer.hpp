@@ -0,0 +1,55 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <cstdint>
+
+#include "sdl/RenderTarget.hpp"
+#include "sdl/Renderer.hpp"
+
+namespace eerium
+{
+
+using PickId = uint32_t;
+
+/**
+ * Off-screen ID buffer for pixel-accurate picking.
+ *
+ * Between Begin() and End() the caller draws every pickable shape in painter's
+ * order, filled with ColorOf(id) instead of its texture. The buffer has a
+ * fraction of the window resolution and the shapes are drawn in window
+ * coordinates. Pick() reads back just the pixel under a window position, so a
+ * query costs the same however many shapes overlap there.
+ */
+class PickBuffer
+{
+public:
+    static constexpr PickId kNone = 0;
+    static constexpr PickId kMaxId = 0xFFFFFF;  // ids are stored in the RGB channels
+    static constexpr float kDefaultScale = 0.5f;
+
+    explicit PickBuffer(float scale = kDefaultScale) : scale_(scale) {}
+
+    // Redirect rendering into the buffer and clear it to kNone
+    void Begin(sdl::Renderer& renderer);
+
+    // Back to the window
+    void End(sdl::Renderer& renderer);
+
+    // Fill color for the shapes of `id`
+    static SDL_FColor ColorOf(PickId id)
+    {
+        return {static_cast<float>((id >> 16) & 0xFF) / 255.0f, static_cast<float>((id >> 8) & 0xFF) / 255.0f,
+                static_cast<float>(id & 0xFF) / 255.0f, 1.0f};
+    }
+
+    // Id drawn last under a window position, kNone if nothing was drawn there
+    PickId Pick(sdl::Renderer& renderer, float x, float y);
+
+private:
+    float scale_;
+    sdl::RenderTarget target_;
+    SDL_BlendMode saved_blend_mode_ = SDL_BLENDMODE_BLEND;
+};
+
+}  // namespace eerium
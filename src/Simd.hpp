@@ -0,0 +1,20 @@
+#pragma once
+
+// Compile-time selection of the SIMD instruction sets used by the batch kernels.
+// SSE2 is always available on x86-64; AVX2 is opt-in through the
+// EERIUM_ENABLE_AVX2 CMake option (-mavx2 -mfma). Other architectures use the
+// scalar paths, which are written so the compiler can auto-vectorize them.
+
+#if defined(__AVX2__)
+#define EERIUM_SIMD_AVX2 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EERIUM_SIMD_SSE2 1
+#endif
+
+#if defined(EERIUM_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(EERIUM_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
@@ -0,0 +1,171 @@
+#include "SpatialHash.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace eerium
+{
+
+SpatialHash::SpatialHash(int width, int height, int cell_size)
+    : cell_size_(std::max(1, cell_size)),
+      inv_cell_size_(1.0f / static_cast<float>(cell_size_)),
+      cells_x_(std::max(1, (width + cell_size_ - 1) / cell_size_)),
+      cells_y_(std::max(1, (height + cell_size_ - 1) / cell_size_)),
+      cells_(static_cast<size_t>(cells_x_) * cells_y_)
+{
+}
+
+int SpatialHash::CellX(float x) const
+{
+    return std::clamp(static_cast<int>(std::floor(x * inv_cell_size_)), 0, cells_x_ - 1);
+}
+
+int SpatialHash::CellY(float y) const
+{
+    return std::clamp(static_cast<int>(std::floor(y * inv_cell_size_)), 0, cells_y_ - 1);
+}
+
+void SpatialHash::Clear()
+{
+    for (auto& cell : cells_)
+    {
+        cell.clear();
+    }
+    locations_.clear();
+    size_ = 0;
+}
+
+void SpatialHash::Insert(EntityId id, float x, float y)
+{
+    if (id >= locations_.size())
+    {
+        locations_.resize(static_cast<size_t>(id) + 1);
+    }
+    if (locations_[id].cell != kNoCell)
+    {
+        Move(id, x, y);
+        return;
+    }
+    AddToCell(CellOf(x, y), id, x, y);
+    ++size_;
+}
+
+void SpatialHash::Move(EntityId id, float x, float y)
+{
+    const Location location = locations_[id];
+    const uint32_t cell = CellOf(x, y);
+    if (cell == location.cell)
+    {
+        // Common case: still in the same cell
+        Entry& entry = cells_[cell][location.slot];
+        entry.x = x;
+        entry.y = y;
+        return;
+    }
+    RemoveFromCell(id);
+    AddToCell(cell, id, x, y);
+}
+
+void SpatialHash::Remove(EntityId id)
+{
+    if (!Contains(id))
+    {
+        return;
+    }
+    RemoveFromCell(id);
+    locations_[id].cell = kNoCell;
+    --size_;
+}
+
+void SpatialHash::AddToCell(uint32_t cell, EntityId id, float x, float y)
+{
+    auto& entries = cells_[cell];
+    locations_[id] = {cell, static_cast<uint32_t>(entries.size())};
+    entries.push_back({id, x, y});
+}
+
+void SpatialHash::RemoveFromCell(EntityId id)
+{
+    const Location location = locations_[id];
+    auto& entries = cells_[location.cell];
+    if (location.slot != entries.size() - 1)
+    {
+        entries[location.slot] = entries.back();
+        locations_[entries[location.slot].id].slot = location.slot;
+    }
+    entries.pop_back();
+}
+
+void SpatialHash::Sync(const EntityStore& store)
+{
+    const auto& ids = store.GetIds();
+    const auto& pos_x = store.PositionsX();
+    const auto& pos_y = store.PositionsY();
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        if (Contains(ids[i]))
+        {
+            Move(ids[i], pos_x[i], pos_y[i]);
+        }
+        else
+        {
+            Insert(ids[i], pos_x[i], pos_y[i]);
+        }
+    }
+}
+
+void SpatialHash::QueryRadius(float x, float y, float radius, std::vector<EntityId>& out) const
+{
+    const float radius_squared = radius * radius;
+    ForEachEntry(x - radius, y - radius, x + radius, y + radius, [&](const Entry& entry)
+                 {
+                     float dx = entry.x - x;
+                     float dy = entry.y - y;
+                     if (dx * dx + dy * dy <= radius_squared)
+                     {
+                         out.push_back(entry.id);
+                     }
+                 });
+}
+
+void SpatialHash::QueryRect(float min_x, float min_y, float max_x, float max_y, std::vector<EntityId>& out) const
+{
+    ForEachEntry(min_x, min_y, max_x, max_y, [&](const Entry& entry)
+                 {
+                     if (entry.x >= min_x && entry.x <= max_x && entry.y >= min_y && entry.y <= max_y)
+                     {
+                         out.push_back(entry.id);
+                     }
+                 });
+}
+
+void SpatialHash::QueryDiamond(float x, float y, float radius, std::vector<EntityId>& out) const
+{
+    ForEachEntry(x - radius, y - radius, x + radius, y + radius, [&](const Entry& entry)
+                 {
+                     if (std::abs(entry.x - x) + std::abs(entry.y - y) <= radius)
+                     {
+                         out.push_back(entry.id);
+                     }
+                 });
+}
+
+EntityId SpatialHash::FindNearest(float x, float y, float radius) const
+{
+    EntityId nearest = kInvalidEntity;
+    float nearest_squared = radius * radius;
+    ForEachEntry(x - radius, y - radius, x + radius, y + radius, [&](const Entry& entry)
+                 {
+                     float dx = entry.x - x;
+                     float dy = entry.y - y;
+                     float distance_squared = dx * dx + dy * dy;
+                     if (distance_squared <= nearest_squared)
+                     {
+                         nearest = entry.id;
+                         nearest_squared = distance_squared;
+                     }
+                 });
+    return nearest;
+}
+
+}  // namespace eerium
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "EntityStore.hpp"
+
+namespace eerium
+{
+
+/**
+ * Uniform grid of entity buckets over tile space, for proximity queries.
+ *
+ * Every cell covers cell_size x cell_size tiles and holds the ids and
+ * positions of the entities inside it. Entities remember their cell and slot,
+ * so moving within a cell only rewrites the stored position and moving to
+ * another cell is two swap-removal steps. Queries visit just the cells the
+ * query shape overlaps. Positions outside the map fall into the border cells.
+ */
+class SpatialHash
+{
+public:
+    static constexpr int kDefaultCellSize = 2;  // tiles
+
+    SpatialHash(int width, int height, int cell_size = kDefaultCellSize);
+
+    void Clear();
+    void Insert(EntityId id, float x, float y);
+    void Move(EntityId id, float x, float y);
+    void Remove(EntityId id);
+
+    bool Contains(EntityId id) const { return id < locations_.size() && locations_[id].cell != kNoCell; }
+    size_t Size() const { return size_; }
+
+    // Move every entity of the store to its current position, inserting new ones;
+    // entities destroyed in the store have to be removed separately
+    void Sync(const EntityStore& store);
+
+    // Queries append the ids of the matching entities to `out`
+    void QueryRadius(float x, float y, float radius, std::vector<EntityId>& out) const;
+    void QueryRect(float min_x, float min_y, float max_x, float max_y, std::vector<EntityId>& out) const;
+    void QueryDiamond(float x, float y, float radius, std::vector<EntityId>& out) const;  // |dx| + |dy| <= radius
+
+    // Closest entity within radius, kInvalidEntity if there is none
+    EntityId FindNearest(float x, float y, float radius) const;
+
+    /**
+     * @brief Call fn(a, b) once for every pair of entities closer than radius
+     *
+     * Walks the grid cell by cell and only compares a cell with itself and
+     * its forward neighbors, which makes collision passes over all entities
+     * far cheaper than one radius query per entity. radius must not exceed
+     * the cell size.
+     */
+    template <typename Fn>
+    void ForEachPair(float radius, Fn&& fn) const
+    {
+        const float radius_squared = radius * radius;
+        auto test = [&](const Entry& a, const Entry& b)
+        {
+            float dx = a.x - b.x;
+            float dy = a.y - b.y;
+            if (dx * dx + dy * dy < radius_squared)
+            {
+                fn(a.id, b.id);
+            }
+        };
+
+        // Right, bottom-left, bottom and bottom-right: every neighboring cell pair is visited once
+        static constexpr int kForward[4][2] = {{1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+        for (int cy = 0; cy < cells_y_; ++cy)
+        {
+            for (int cx = 0; cx < cells_x_; ++cx)
+            {
+                const auto& cell = cells_[static_cast<size_t>(cy) * cells_x_ + cx];
+                for (size_t i = 0; i < cell.size(); ++i)
+                {
+                    for (size_t j = i + 1; j < cell.size(); ++j)
+                    {
+                        test(cell[i], cell[j]);
+                    }
+                }
+                for (const auto& offset : kForward)
+                {
+                    const int nx = cx + offset[0];
+                    const int ny = cy + offset[1];
+                    if (nx < 0 || nx >= cells_x_ || ny >= cells_y_)
+                    {
+                        continue;
+                    }
+                    for (const Entry& b : cells_[static_cast<size_t>(ny) * cells_x_ + nx])
+                    {
+                        for (const Entry& a : cell)
+                        {
+                            test(a, b);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr uint32_t kNoCell = std::numeric_limits<uint32_t>::max();
+
+    struct Entry
+    {
+        EntityId id;
+        float x;
+        float y;
+    };
+
+    struct Location
+    {
+        uint32_t cell = kNoCell;
+        uint32_t slot = 0;  // index into the cell's entries
+    };
+
+    int CellX(float x) const;
+    int CellY(float y) const;
+    uint32_t CellOf(float x, float y) const { return static_cast<uint32_t>(CellY(y) * cells_x_ + CellX(x)); }
+    void AddToCell(uint32_t cell, EntityId id, float x, float y);
+    void RemoveFromCell(EntityId id);
+
+    // Call fn(entry) for every entry in the cells overlapping the rectangle
+    template <typename Fn>
+    void ForEachEntry(float min_x, float min_y, float max_x, float max_y, Fn&& fn) const
+    {
+        const int first_x = CellX(min_x);
+        const int last_x = CellX(max_x);
+        const int first_y = CellY(min_y);
+        const int last_y = CellY(max_y);
+        for (int cy = first_y; cy <= last_y; ++cy)
+        {
+            for (int cx = first_x; cx <= last_x; ++cx)
+            {
+                for (const Entry& entry : cells_[static_cast<size_t>(cy) * cells_x_ + cx])
+                {
+                    fn(entry);
+                }
+            }
+        }
+    }
+
+    int cell_size_;
+    float inv_cell_size_;
+    int cells_x_;
+    int cells_y_;
+    std::vector<std::vector<Entry>> cells_;
+    std::vector<Location> locations_;  // indexed by EntityId
+    size_t size_ = 0;
+};
+
+}  // namespace eerium
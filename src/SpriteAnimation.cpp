@@ -0,0 +1,121 @@
+#include "SpriteAnimation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "sdl/Exception.hpp"
+
+namespace eerium
+{
+
+SpriteAtlas::~SpriteAtlas()
+{
+    if (texture_)
+    {
+        SDL_DestroyTexture(texture_);
+    }
+}
+
+SpriteAtlas::SpriteAtlas(SpriteAtlas&& other) noexcept
+    : texture_(other.texture_), frames_(std::move(other.frames_)), frame_aspect_(other.frame_aspect_)
+{
+    other.texture_ = nullptr;
+}
+
+SpriteAtlas& SpriteAtlas::operator=(SpriteAtlas&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (texture_)
+        {
+            SDL_DestroyTexture(texture_);
+        }
+        texture_ = other.texture_;
+        frames_ = std::move(other.frames_);
+        frame_aspect_ = other.frame_aspect_;
+        other.texture_ = nullptr;
+    }
+    return *this;
+}
+
+void SpriteAtlas::Create(SDL_Renderer* renderer, SDL_Surface* sheet, int frame_width, int frame_height)
+{
+    if (texture_)
+    {
+        SDL_DestroyTexture(texture_);
+        texture_ = nullptr;
+    }
+    frames_.clear();
+
+    texture_ = SDL_CreateTextureFromSurface(renderer, sheet);
+    if (!texture_)
+    {
+        throw sdl::Exception(std::string("Sprite atlas could not be created! SDL_Error: ") + SDL_GetError());
+    }
+
+    const int columns = sheet->w / frame_width;
+    const int rows = sheet->h / frame_height;
+    const float u = static_cast<float>(frame_width) / static_cast<float>(sheet->w);
+    const float v = static_cast<float>(frame_height) / static_cast<float>(sheet->h);
+    frames_.reserve(static_cast<size_t>(columns) * rows);
+    for (int row = 0; row < rows; ++row)
+    {
+        for (int column = 0; column < columns; ++column)
+        {
+            frames_.push_back({column * u, row * v, u, v});
+        }
+    }
+    frame_aspect_ = static_cast<float>(frame_height) / static_cast<float>(frame_width);
+}
+
+void SpriteAtlas::Draw(sdl::CommandBuffer& commands, uint16_t frame, const SDL_FRect& dest, SDL_FColor tint) const
+{
+    const SDL_FRect& uv = frames_[frame];
+    const SDL_Vertex quad[4] = {
+        {{dest.x, dest.y}, tint, {uv.x, uv.y}},
+        {{dest.x + dest.w, dest.y}, tint, {uv.x + uv.w, uv.y}},
+        {{dest.x + dest.w, dest.y + dest.h}, tint, {uv.x + uv.w, uv.y + uv.h}},
+        {{dest.x, dest.y + dest.h}, tint, {uv.x, uv.y + uv.h}},
+    };
+    const int indices[] = {0, 1, 2, 0, 2, 3};
+    commands.Geometry(texture_, quad, indices);
+}
+
+ClipId SpriteAnimator::AddClip(const AnimationClip& clip)
+{
+    clips_.push_back(clip);
+    clip_length_.push_back(clip.frame_duration * clip.frame_count);
+    return static_cast<ClipId>(clips_.size() - 1);
+}
+
+void SpriteAnimator::Resize(size_t slot_count)
+{
+    clip_.resize(slot_count, 0);
+    time_.resize(slot_count, 0.0f);
+}
+
+void SpriteAnimator::Update(float dt)
+{
+    for (size_t i = 0; i < time_.size(); ++i)
+    {
+        // Looping clips wrap, so the time never grows large enough to lose precision
+        float time = time_[i] + dt;
+        const float length = clip_length_[clip_[i]];
+        if (clips_[clip_[i]].loop && time >= length)
+        {
+            time = std::fmod(time, length);
+        }
+        time_[i] = time;
+    }
+}
+
+uint16_t SpriteAnimator::GetFrame(size_t slot) const
+{
+    const AnimationClip& clip = clips_[clip_[slot]];
+    int frame = static_cast<int>(time_[slot] / clip.frame_duration);
+    frame = clip.loop ? frame % clip.frame_count : std::min<int>(frame, clip.frame_count - 1);
+    return static_cast<uint16_t>(clip.first_frame + frame);
+}
+
+}  // namespace eerium
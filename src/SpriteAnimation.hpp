@@ -0,0 +1,115 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "sdl/CommandBuffer.hpp"
+
+namespace eerium
+{
+
+using ClipId = uint16_t;
+
+// A run of consecutive atlas frames played at a fixed rate
+struct AnimationClip
+{
+    uint16_t first_frame;
+    uint16_t frame_count;
+    float frame_duration;  // seconds
+    bool loop;
+};
+
+/**
+ * @brief Sprite sheet uploaded as one texture
+ *
+ * The sheet is cut into a grid of equally sized frames, numbered row by row.
+ * Frames are kept as texture coordinates, ready to be put into vertices.
+ */
+class SpriteAtlas
+{
+public:
+    SpriteAtlas() = default;
+    ~SpriteAtlas();
+
+    // Move semantics
+    SpriteAtlas(SpriteAtlas&& other) noexcept;
+    SpriteAtlas& operator=(SpriteAtlas&& other) noexcept;
+
+    // Disable copy
+    SpriteAtlas(const SpriteAtlas&) = delete;
+    SpriteAtlas& operator=(const SpriteAtlas&) = delete;
+
+    /**
+     * @brief Upload a sprite sheet, replacing the previous one
+     * @throws sdl::Exception if the texture cannot be created
+     */
+    void Create(SDL_Renderer* renderer, SDL_Surface* sheet, int frame_width, int frame_height);
+
+    bool IsLoaded() const noexcept { return texture_ != nullptr; }
+    SDL_Texture* GetTexture() const noexcept { return texture_; }
+
+    size_t GetFrameCount() const noexcept { return frames_.size(); }
+    const SDL_FRect& GetFrame(uint16_t frame) const { return frames_[frame]; }
+
+    // Height of a frame per unit of width
+    float GetFrameAspect() const noexcept { return frame_aspect_; }
+
+    // Record a frame stretched over `dest`, its colors multiplied by `tint`
+    void Draw(sdl::CommandBuffer& commands, uint16_t frame, const SDL_FRect& dest, SDL_FColor tint) const;
+
+private:
+    SDL_Texture* texture_ = nullptr;
+    std::vector<SDL_FRect> frames_;  // texture coordinates, 0..1
+    float frame_aspect_ = 1.0f;
+};
+
+/**
+ * Playback state of many animated sprites in flat arrays.
+ *
+ * Every sprite is a slot holding the clip it plays and how far it got, so
+ * advancing thousands of them is one pass over two columns. The frame to draw
+ * is derived from the time only when it is asked for.
+ */
+class SpriteAnimator
+{
+public:
+    ClipId AddClip(const AnimationClip& clip);
+
+    // Slots added here play clip 0 from the start
+    void Resize(size_t slot_count);
+    size_t Size() const { return clip_.size(); }
+
+    // Switch a slot to a clip; playing the clip it already plays keeps its time
+    void Play(size_t slot, ClipId clip)
+    {
+        if (clip_[slot] != clip)
+        {
+            Start(slot, clip);
+        }
+    }
+
+    // Play a clip from `start_time` on, even if the slot already plays it
+    void Start(size_t slot, ClipId clip, float start_time = 0.0f)
+    {
+        clip_[slot] = clip;
+        time_[slot] = start_time;
+    }
+
+    // Advance every slot by dt seconds
+    void Update(float dt);
+
+    // Atlas frame a slot shows now
+    uint16_t GetFrame(size_t slot) const;
+
+private:
+    std::vector<AnimationClip> clips_;
+    std::vector<float> clip_length_;  // per clip, seconds
+
+    std::vector<ClipId> clip_;
+    std::vector<float> time_;
+};
+
+}  // namespace eerium
@@ -0,0 +1,69 @@
+#include "TerrainMesh.hpp"
+
+#include <algorithm>
+
+namespace eerium
+{
+
+void TerrainMesh::Clear()
+{
+    vertices_.clear();
+    indices_.clear();
+    runs_.clear();
+    bounds_ = {0.0f, 0.0f, 0.0f, 0.0f};
+}
+
+void TerrainMesh::SetRun(uint32_t depth, SDL_Texture* texture)
+{
+    depth_ = depth;
+    texture_ = texture;
+}
+
+void TerrainMesh::Add(std::span<const SDL_Vertex> vertices, std::span<const int> indices)
+{
+    if (vertices.empty() || indices.empty())
+    {
+        return;
+    }
+    if (runs_.empty() || runs_.back().depth != depth_ || runs_.back().texture != texture_)
+    {
+        runs_.push_back({depth_, texture_, static_cast<uint32_t>(vertices_.size()), 0,
+                         static_cast<uint32_t>(indices_.size()), 0});
+    }
+
+    Run& run = runs_.back();
+    const int base = static_cast<int>(run.vertex_count);
+    for (int index : indices)
+    {
+        indices_.push_back(base + index);
+    }
+    run.vertex_count += static_cast<uint32_t>(vertices.size());
+    run.index_count += static_cast<uint32_t>(indices.size());
+
+    // Grow the bounds; an empty mesh takes the first vertex as its start
+    float min_x = vertices_.empty() ? vertices[0].position.x : bounds_.x;
+    float min_y = vertices_.empty() ? vertices[0].position.y : bounds_.y;
+    float max_x = vertices_.empty() ? min_x : bounds_.x + bounds_.w;
+    float max_y = vertices_.empty() ? min_y : bounds_.y + bounds_.h;
+    for (const SDL_Vertex& vertex : vertices)
+    {
+        min_x = std::min(min_x, vertex.position.x);
+        min_y = std::min(min_y, vertex.position.y);
+        max_x = std::max(max_x, vertex.position.x);
+        max_y = std::max(max_y, vertex.position.y);
+    }
+    bounds_ = {min_x, min_y, max_x - min_x, max_y - min_y};
+    vertices_.insert(vertices_.end(), vertices.begin(), vertices.end());
+}
+
+void TerrainMesh::Record(sdl::CommandBuffer& commands) const
+{
+    for (const Run& run : runs_)
+    {
+        commands.SetDepth(run.depth);
+        commands.Geometry(run.texture, std::span(vertices_.data() + run.first_vertex, run.vertex_count),
+                          std::span(indices_.data() + run.first_index, run.index_count));
+    }
+}
+
+}  // namespace eerium
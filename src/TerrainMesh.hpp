@@ -0,0 +1,63 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "sdl/CommandBuffer.hpp"
+
+namespace eerium
+{
+
+/**
+ * Triangles of one terrain chunk, kept between frames.
+ *
+ * The vertices are in world pixels, i.e. the screen positions at the default
+ * zoom without a camera offset, so they stay valid however the camera moves.
+ * Record() hands them to a command buffer whose transform places them on
+ * screen; only edits of the chunk's tiles or fog call for a rebuild.
+ *
+ * Triangles added under the same depth and texture form one run, which is
+ * recorded as one command.
+ */
+class TerrainMesh
+{
+public:
+    void Clear();
+
+    // Depth and texture of the triangles added from now on
+    void SetRun(uint32_t depth, SDL_Texture* texture);
+
+    // Triangles; indices refer to `vertices`
+    void Add(std::span<const SDL_Vertex> vertices, std::span<const int> indices);
+
+    bool IsEmpty() const { return runs_.empty(); }
+
+    // World pixels covered by the triangles
+    const SDL_FRect& GetBounds() const { return bounds_; }
+
+    // Record every run at its depth, into the layer and transform `commands` is set to
+    void Record(sdl::CommandBuffer& commands) const;
+
+private:
+    struct Run
+    {
+        uint32_t depth;
+        SDL_Texture* texture;
+        uint32_t first_vertex;
+        uint32_t vertex_count;
+        uint32_t first_index;
+        uint32_t index_count;
+    };
+
+    uint32_t depth_ = 0;
+    SDL_Texture* texture_ = nullptr;
+    std::vector<SDL_Vertex> vertices_;
+    std::vector<int> indices_;  // relative to the first vertex of their run
+    std::vector<Run> runs_;
+    SDL_FRect bounds_ = {0.0f, 0.0f, 0.0f, 0.0f};
+};
+
+}  // namespace eerium
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace eerium
+{
+
+enum class Material : uint8_t
+{
+    GRASS,
+    DIRT,
+    STONE
+};
+
+// Something standing on a tile, drawn depth-sorted together with the entities
+enum class TileObject : uint8_t
+{
+    NONE,
+    WALL
+};
+
+// Layered tile: ground material at some elevation, optionally with an object on top
+struct Tile
+{
+    static constexpr uint8_t kMaxElevation = 3;
+
+    Material material = Material::GRASS;
+    uint8_t elevation = 0;  // ground height in steps, 0..kMaxElevation
+    TileObject object = TileObject::NONE;
+
+    bool operator==(const Tile&) const = default;
+};
+
+// A tile edited through TileMap::SetTile(), with its contents before and after
+struct TileChange
+{
+    int x = 0;
+    int y = 0;
+    Tile before;
+    Tile after;
+};
+
+/**
+ * One bit per map chunk, for consumers that rebuild derived data chunk by chunk.
+ */
+class ChunkMask
+{
+public:
+    void Resize(size_t chunk_count) { bits_.assign((chunk_count + 63) / 64, 0); }
+    void Clear() { std::fill(bits_.begin(), bits_.end(), 0); }
+
+    void Set(size_t chunk) { bits_[chunk / 64] |= uint64_t{1} << (chunk % 64); }
+    bool Test(size_t chunk) const { return (bits_[chunk / 64] >> (chunk % 64)) & 1; }
+
+    bool Any() const
+    {
+        return std::any_of(bits_.begin(), bits_.end(), [](uint64_t word)
+                           { return word != 0; });
+    }
+
+    // Add every chunk set in other; both masks must be sized for the same map
+    void Merge(const ChunkMask& other)
+    {
+        for (size_t i = 0; i < bits_.size() && i < other.bits_.size(); ++i)
+        {
+            bits_[i] |= other.bits_[i];
+        }
+    }
+
+    // Call fn(chunk) for every set chunk, in ascending order
+    template <typename Fn>
+    void ForEach(Fn&& fn) const
+    {
+        for (size_t word = 0; word < bits_.size(); ++word)
+        {
+            for (uint64_t bits = bits_[word]; bits != 0; bits &= bits - 1)
+            {
+                fn(word * 64 + static_cast<size_t>(std::countr_zero(bits)));
+            }
+        }
+    }
+
+private:
+    std::vector<uint64_t> bits_;
+};
+
+// Cost of entering a tile of the given material, relative to other walkable
+// materials; 0 means the tile cannot be walked on
+static constexpr uint8_t MaterialMoveCost(Material material)
+{
+    switch (material)
+    {
+        case Material::GRASS:
+            return 10;
+        case Material::DIRT:
+            return 8;  // trodden paths are slightly faster
+        case Material::STONE:
+            return 0;
+    }
+    return 0;
+}
+
+// Whether a tile of the given material blocks line of sight; the tile itself
+// can still be seen
+static constexpr bool MaterialBlocksSight(Material material)
+{
+    switch (material)
+    {
+        case Material::GRASS:
+        case Material::DIRT:
+            return false;
+        case Material::STONE:
+            return true;
+    }
+    return true;
+}
+
+// Movement cost of a whole tile: objects block, otherwise the material decides
+static constexpr uint8_t TileMoveCost(const Tile& tile)
+{
+    return tile.object != TileObject::NONE ? 0 : MaterialMoveCost(tile.material);
+}
+
+static constexpr bool TileBlocksSight(const Tile& tile)
+{
+    return tile.object == TileObject::WALL || MaterialBlocksSight(tile.material);
+}
+
+/**
+ * Rectangular grid of tiles stored row-major in one flat array.
+ *
+ * Coordinates are (x, y) = (column, row), matching IsoGrid's TileCoord.
+ * The map is logically divided into square chunks of kChunkSize tiles, which
+ * is the granularity used by caches and derived structures built on top of it.
+ *
+ * At() gives direct access for generating a map; derived structures have to
+ * be rebuilt from scratch after that. Edits made through SetTile() are
+ * recorded instead: TakeChanges() hands them out once per frame, one entry per
+ * edited tile however often it changed, together with the affected chunks.
+ */
+class TileMap
+{
+public:
+    static constexpr int kChunkSize = 16;
+
+    TileMap(int width, int height)
+        : width_(width), height_(height), tiles_(static_cast<size_t>(width) * height),
+          pending_(tiles_.size(), 0)
+    {
+    }
+
+    int GetWidth() const { return width_; }
+    int GetHeight() const { return height_; }
+    int GetChunksX() const { return (width_ + kChunkSize - 1) / kChunkSize; }
+    int GetChunksY() const { return (height_ + kChunkSize - 1) / kChunkSize; }
+
+    bool InBounds(int x, int y) const
+    {
+        return x >= 0 && y >= 0 && x < width_ && y < height_;
+    }
+
+    size_t IndexOf(int x, int y) const { return static_cast<size_t>(y) * width_ + x; }
+    size_t GetChunkCount() const { return static_cast<size_t>(GetChunksX()) * GetChunksY(); }
+    size_t ChunkIndexOf(int x, int y) const
+    {
+        return static_cast<size_t>(y / kChunkSize) * GetChunksX() + x / kChunkSize;
+    }
+
+    Tile& At(int x, int y) { return tiles_[IndexOf(x, y)]; }
+    const Tile& At(int x, int y) const { return tiles_[IndexOf(x, y)]; }
+
+    std::span<const Tile> GetTiles() const { return tiles_; }
+
+    // Recorded edit; returns false if the tile is out of bounds or already equal
+    bool SetTile(int x, int y, const Tile& tile)
+    {
+        if (!InBounds(x, y))
+        {
+            return false;
+        }
+        const size_t index = IndexOf(x, y);
+        if (tiles_[index] == tile)
+        {
+            return false;
+        }
+        if (!pending_[index])
+        {
+            // First edit of this tile since the last TakeChanges()
+            pending_[index] = 1;
+            changes_.push_back({x, y, tiles_[index], tile});
+        }
+        tiles_[index] = tile;
+        return true;
+    }
+
+    bool HasChanges() const { return !changes_.empty(); }
+
+    /**
+     * @brief Hand out the edits since the last call
+     * @param changes Replaced with the net change of every edited tile; tiles
+     *                edited back to what they were are left out
+     * @param dirty Gets the chunks of those tiles added; Resize() it to GetChunkCount() first
+     */
+    void TakeChanges(std::vector<TileChange>& changes, ChunkMask& dirty)
+    {
+        changes.clear();
+        for (TileChange& change : changes_)
+        {
+            const size_t index = IndexOf(change.x, change.y);
+            pending_[index] = 0;
+            change.after = tiles_[index];
+            if (change.after == change.before)
+            {
+                continue;
+            }
+            dirty.Set(ChunkIndexOf(change.x, change.y));
+            changes.push_back(change);
+        }
+        changes_.clear();
+    }
+
+private:
+    int width_;
+    int height_;
+    std::vector<Tile> tiles_;
+
+    // Edits recorded by SetTile(); pending_ flags the tiles that already have an entry
+    std::vector<TileChange> changes_;
+    std::vector<uint8_t> pending_;
+};
+
+}  // namespace eerium
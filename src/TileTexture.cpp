@@ -0,0 +1,70 @@
+#include "TileTexture.hpp"
+
+#include <algorithm>
+#include <string>
+
+#include "sdl/Exception.hpp"
+
+namespace eerium
+{
+
+TileTexture::TileTexture(int width, int height, sdl::Color fill)
+    : width_(width),
+      height_(height),
+      chunks_x_((width + TileMap::kChunkSize - 1) / TileMap::kChunkSize),
+      pixels_(static_cast<size_t>(width) * height, fill)
+{
+    const int chunks_y = (height + TileMap::kChunkSize - 1) / TileMap::kChunkSize;
+    dirty_.Resize(static_cast<size_t>(chunks_x_) * chunks_y);
+}
+
+TileTexture::~TileTexture()
+{
+    if (texture_)
+    {
+        SDL_DestroyTexture(texture_);
+    }
+}
+
+void TileTexture::SetTile(int x, int y, sdl::Color color)
+{
+    pixels_[static_cast<size_t>(y) * width_ + x] = color;
+    dirty_.Set(static_cast<size_t>(y / TileMap::kChunkSize) * chunks_x_ + x / TileMap::kChunkSize);
+}
+
+SDL_Texture* TileTexture::Get(SDL_Renderer* renderer)
+{
+    if (!texture_)
+    {
+        texture_ = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, width_, height_);
+        if (!texture_)
+        {
+            throw sdl::Exception(std::string("Tile texture could not be created! SDL_Error: ") + SDL_GetError());
+        }
+        SDL_SetTextureScaleMode(texture_, SDL_SCALEMODE_NEAREST);
+        SDL_SetTextureBlendMode(texture_, SDL_BLENDMODE_BLEND);
+        all_dirty_ = true;
+    }
+
+    const int pitch = width_ * static_cast<int>(sizeof(sdl::Color));
+    if (all_dirty_)
+    {
+        SDL_UpdateTexture(texture_, nullptr, pixels_.data(), pitch);
+        all_dirty_ = false;
+    }
+    else
+    {
+        dirty_.ForEach([&](size_t chunk)
+                       {
+                           int x = static_cast<int>(chunk % chunks_x_) * TileMap::kChunkSize;
+                           int y = static_cast<int>(chunk / chunks_x_) * TileMap::kChunkSize;
+                           SDL_Rect rect = {x, y, std::min(TileMap::kChunkSize, width_ - x),
+                                            std::min(TileMap::kChunkSize, height_ - y)};
+                           SDL_UpdateTexture(texture_, &rect, &pixels_[static_cast<size_t>(y) * width_ + x], pitch);
+                       });
+    }
+    dirty_.Clear();
+    return texture_;
+}
+
+}  // namespace eerium
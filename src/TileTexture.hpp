@@ -0,0 +1,49 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <vector>
+
+#include "TileMap.hpp"
+#include "sdl/Color.hpp"
+
+namespace eerium
+{
+
+/**
+ * Texture with one pixel per map tile, updated a chunk at a time.
+ *
+ * The colors live in a CPU-side copy of the texture. SetTile() only changes
+ * the copy and marks its chunk; Get() uploads the marked chunks, so a frame
+ * costs whatever was edited, however large the map is. The texture uses
+ * nearest filtering, so every tile stays a sharp block when stretched.
+ */
+class TileTexture
+{
+public:
+    TileTexture(int width, int height, sdl::Color fill);
+    ~TileTexture();
+
+    // Disable copy
+    TileTexture(const TileTexture&) = delete;
+    TileTexture& operator=(const TileTexture&) = delete;
+
+    void SetTile(int x, int y, sdl::Color color);
+
+    // The texture with every change uploaded, created on first use; throws sdl::Exception if that fails
+    SDL_Texture* Get(SDL_Renderer* renderer);
+
+    int GetWidth() const { return width_; }
+    int GetHeight() const { return height_; }
+
+private:
+    int width_;
+    int height_;
+    int chunks_x_;
+    std::vector<sdl::Color> pixels_;  // row-major, laid out like SDL_PIXELFORMAT_RGBA32
+    ChunkMask dirty_;
+    bool all_dirty_ = true;
+    SDL_Texture* texture_ = nullptr;
+};
+
+}  // namespace eerium
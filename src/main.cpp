@@ -1,15 +1,90 @@
+#include <charconv>
 #include <exception>
 #include <print>
+#include <string_view>
 
 #include "Game.hpp"
 
 using namespace eerium;
 
-int main()
+namespace
 {
+
+void PrintUsage(const char* program)
+{
+    std::println(stderr, "Usage: {} [--record <file>] [--replay <file> [--headless]]", program);
+    std::println(stderr, "       {} --frames <n> [--dump-every <n>] [--frame-dir <dir>] [--headless]", program);
+}
+
+// Positive count, false if `arg` is anything else
+bool ParseCount(std::string_view arg, int& count)
+{
+    auto [end, error] = std::from_chars(arg.data(), arg.data() + arg.size(), count);
+    return error == std::errc() && end == arg.data() + arg.size() && count > 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    Game::Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        if (arg == "--record" && i + 1 < argc)
+        {
+            options.record_path = argv[++i];
+        }
+        else if (arg == "--replay" && i + 1 < argc)
+        {
+            options.replay_path = argv[++i];
+        }
+        else if (arg == "--headless")
+        {
+            options.headless = true;
+        }
+        else if (arg == "--frames" && i + 1 < argc && ParseCount(argv[i + 1], options.frames))
+        {
+            ++i;
+        }
+        else if (arg == "--dump-every" && i + 1 < argc && ParseCount(argv[i + 1], options.dump_every))
+        {
+            ++i;
+        }
+        else if (arg == "--frame-dir" && i + 1 < argc)
+        {
+            options.frame_dir = argv[++i];
+        }
+        else
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Scripted frames drive the game themselves, they cannot record or replay input
+    if (options.frames > 0 && (!options.record_path.empty() || !options.replay_path.empty()))
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    // Without a replay or scripted frames there would be nobody to play a hidden window
+    if (options.headless && options.replay_path.empty() && options.frames == 0)
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    // Scripted frames without a window need no display at all
+    if (options.headless && options.frames > 0)
+    {
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+    }
+
     try
     {
-        Game game;
+        Game game(options);
         game.Run();
         return 0;
     }
@@ -0,0 +1,319 @@
+#include "CommandBuffer.hpp"
+
+#include <utility>
+
+namespace eerium::sdl
+{
+
+namespace
+{
+
+// Position of a command in the submitted stream, with its sort key at hand
+struct CommandRef
+{
+    uint64_t key;
+    uint32_t buffer;
+    uint32_t command;
+};
+
+// Stable LSD radix sort by key, one byte per pass. Bytes that every key
+// shares are skipped, which leaves a pass or two for the layers and depths in
+// use; commands arrive in recording order and keep it among equal keys.
+void SortByKey(std::vector<CommandRef>& refs, std::vector<CommandRef>& scratch)
+{
+    uint64_t all_set = ~uint64_t{0};
+    uint64_t any_set = 0;
+    for (const CommandRef& ref : refs)
+    {
+        all_set &= ref.key;
+        any_set |= ref.key;
+    }
+    const uint64_t varying = all_set ^ any_set;
+
+    scratch.resize(refs.size());
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        if (((varying >> shift) & 0xFF) == 0)
+        {
+            continue;
+        }
+        size_t starts[256] = {};
+        for (const CommandRef& ref : refs)
+        {
+            ++starts[(ref.key >> shift) & 0xFF];
+        }
+        size_t offset = 0;
+        for (size_t& start : starts)
+        {
+            size_t count = start;
+            start = offset;
+            offset += count;
+        }
+        for (const CommandRef& ref : refs)
+        {
+            scratch[starts[(ref.key >> shift) & 0xFF]++] = ref;
+        }
+        refs.swap(scratch);
+    }
+}
+
+bool SameClip(const SDL_Rect* a, const SDL_Rect* b)
+{
+    if (!a || !b)
+    {
+        return a == b;
+    }
+    return a->x == b->x && a->y == b->y && a->w == b->w && a->h == b->h;
+}
+
+}  // namespace
+
+CommandBuffer::~CommandBuffer()
+{
+    Reset();
+}
+
+CommandBuffer::CommandBuffer(CommandBuffer&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+CommandBuffer& CommandBuffer::operator=(CommandBuffer&& other) noexcept
+{
+    if (this != &other)
+    {
+        Reset();  // the textures adopted so far are destroyed, as on destruction
+        layer_ = other.layer_;
+        depth_ = other.depth_;
+        clip_ = other.clip_;
+        scale_ = other.scale_;
+        translation_ = other.translation_;
+        commands_ = std::move(other.commands_);
+        vertices_ = std::move(other.vertices_);
+        indices_ = std::move(other.indices_);
+        points_ = std::move(other.points_);
+        clips_ = std::move(other.clips_);
+        adopted_ = std::move(other.adopted_);
+        other.adopted_.clear();
+        other.Reset();
+    }
+    return *this;
+}
+
+void CommandBuffer::SetClip(const SDL_Rect* clip)
+{
+    if (!clip)
+    {
+        clip_ = kNoClip;
+        return;
+    }
+    if (clip_ == kNoClip || !SameClip(&clips_[clip_], clip))
+    {
+        clip_ = static_cast<uint32_t>(clips_.size());
+        clips_.push_back(*clip);
+    }
+}
+
+void CommandBuffer::Geometry(SDL_Texture* texture, std::span<const SDL_Vertex> vertices, std::span<const int> indices)
+{
+    if (vertices.empty() || indices.empty())
+    {
+        return;
+    }
+    commands_.push_back({Key(), texture, clip_, Kind::GEOMETRY, {},
+                         static_cast<uint32_t>(vertices_.size()), static_cast<uint32_t>(vertices.size()),
+                         static_cast<uint32_t>(indices_.size()), static_cast<uint32_t>(indices.size())});
+    const size_t first = vertices_.size();
+    vertices_.insert(vertices_.end(), vertices.begin(), vertices.end());
+    indices_.insert(indices_.end(), indices.begin(), indices.end());
+    if (IsTransformed())
+    {
+        for (size_t i = first; i < vertices_.size(); ++i)
+        {
+            vertices_[i].position.x = vertices_[i].position.x * scale_ + translation_.x;
+            vertices_[i].position.y = vertices_[i].position.y * scale_ + translation_.y;
+        }
+    }
+}
+
+void CommandBuffer::Texture(SDL_Texture* texture, const SDL_FRect* source, const SDL_FRect& dest, SDL_FColor tint)
+{
+    SDL_FRect uv = {0.0f, 0.0f, 1.0f, 1.0f};
+    if (source)
+    {
+        float width = 1.0f;
+        float height = 1.0f;
+        SDL_GetTextureSize(texture, &width, &height);
+        uv = {source->x / width, source->y / height, source->w / width, source->h / height};
+    }
+
+    const SDL_Vertex quad[4] = {
+        {{dest.x, dest.y}, tint, {uv.x, uv.y}},
+        {{dest.x + dest.w, dest.y}, tint, {uv.x + uv.w, uv.y}},
+        {{dest.x + dest.w, dest.y + dest.h}, tint, {uv.x + uv.w, uv.y + uv.h}},
+        {{dest.x, dest.y + dest.h}, tint, {uv.x, uv.y + uv.h}},
+    };
+    const int indices[] = {0, 1, 2, 0, 2, 3};
+    Geometry(texture, quad, indices);
+}
+
+void CommandBuffer::FillRect(const SDL_FRect& rect, Color color)
+{
+    Texture(nullptr, nullptr, rect, {color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f});
+}
+
+void CommandBuffer::Lines(std::span<const SDL_FPoint> points, Color color)
+{
+    if (points.size() < 2)
+    {
+        return;
+    }
+    commands_.push_back({Key(), nullptr, clip_, Kind::LINES,
+                         {color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f},
+                         static_cast<uint32_t>(points_.size()), static_cast<uint32_t>(points.size()), 0, 0});
+    const size_t first = points_.size();
+    points_.insert(points_.end(), points.begin(), points.end());
+    if (IsTransformed())
+    {
+        for (size_t i = first; i < points_.size(); ++i)
+        {
+            points_[i].x = points_[i].x * scale_ + translation_.x;
+            points_[i].y = points_[i].y * scale_ + translation_.y;
+        }
+    }
+}
+
+void CommandBuffer::Reset()
+{
+    commands_.clear();
+    vertices_.clear();
+    indices_.clear();
+    points_.clear();
+    clips_.clear();
+    clip_ = kNoClip;
+    layer_ = kLayerWorld;
+    depth_ = 0;
+    scale_ = 1.0f;
+    translation_ = {0.0f, 0.0f};
+    for (SDL_Texture* texture : adopted_)
+    {
+        SDL_DestroyTexture(texture);
+    }
+    adopted_.clear();
+}
+
+void CommandBuffer::Submit(SDL_Renderer* renderer)
+{
+    CommandBuffer* self = this;
+    Submit(renderer, std::span(&self, 1));
+}
+
+void CommandBuffer::Submit(SDL_Renderer* renderer, std::span<CommandBuffer* const> buffers)
+{
+    // Render thread scratch, kept between frames
+    static thread_local std::vector<CommandRef> order;
+    static thread_local std::vector<CommandRef> sort_scratch;
+    static thread_local std::vector<SDL_Vertex> merged_vertices;
+    static thread_local std::vector<int> merged_indices;
+
+    order.clear();
+    for (size_t b = 0; b < buffers.size(); ++b)
+    {
+        const std::vector<Command>& commands = buffers[b]->commands_;
+        for (size_t c = 0; c < commands.size(); ++c)
+        {
+            order.push_back({commands[c].key, static_cast<uint32_t>(b), static_cast<uint32_t>(c)});
+        }
+    }
+
+    // Key first; equal keys keep the recording order, a later command may cover an earlier one.
+    // Depths come from the per-diagonal slots, so a counting sort beats comparing.
+    SortByKey(order, sort_scratch);
+    auto command = [&buffers](const CommandRef& ref) -> const Command&
+    {
+        return buffers[ref.buffer]->commands_[ref.command];
+    };
+
+    auto clip_of = [&buffers](const CommandRef& ref) -> const SDL_Rect*
+    {
+        const CommandBuffer& buffer = *buffers[ref.buffer];
+        uint32_t clip = buffer.commands_[ref.command].clip;
+        return clip == kNoClip ? nullptr : &buffer.clips_[clip];
+    };
+
+    const SDL_Rect* current_clip = nullptr;
+    SDL_SetRenderClipRect(renderer, nullptr);
+
+    size_t i = 0;
+    while (i < order.size())
+    {
+        const Command& first = command(order[i]);
+        const SDL_Rect* clip = clip_of(order[i]);
+        if (!SameClip(clip, current_clip))
+        {
+            SDL_SetRenderClipRect(renderer, clip);
+            current_clip = clip;
+        }
+
+        if (first.kind == Kind::LINES)
+        {
+            const CommandBuffer& buffer = *buffers[order[i].buffer];
+            SDL_SetRenderDrawColorFloat(renderer, first.color.r, first.color.g, first.color.b, first.color.a);
+            SDL_RenderLines(renderer, buffer.points_.data() + first.first_vertex, static_cast<int>(first.vertex_count));
+            ++i;
+            continue;
+        }
+
+        // Extend the run while the following geometry can share the draw call
+        size_t end = i + 1;
+        while (end < order.size())
+        {
+            const Command& next = command(order[end]);
+            if (next.kind != Kind::GEOMETRY || next.texture != first.texture || !SameClip(clip_of(order[end]), clip))
+            {
+                break;
+            }
+            ++end;
+        }
+
+        if (end - i == 1)
+        {
+            // Nothing to merge with, draw straight from the recorded arrays
+            const CommandBuffer& buffer = *buffers[order[i].buffer];
+            SDL_RenderGeometry(renderer, first.texture, buffer.vertices_.data() + first.first_vertex,
+                               static_cast<int>(first.vertex_count), buffer.indices_.data() + first.first_index,
+                               static_cast<int>(first.index_count));
+        }
+        else
+        {
+            merged_vertices.clear();
+            merged_indices.clear();
+            for (size_t r = i; r < end; ++r)
+            {
+                const CommandBuffer& buffer = *buffers[order[r].buffer];
+                const Command& part = buffer.commands_[order[r].command];
+                const int base = static_cast<int>(merged_vertices.size());
+                merged_vertices.insert(merged_vertices.end(), buffer.vertices_.begin() + part.first_vertex,
+                                       buffer.vertices_.begin() + part.first_vertex + part.vertex_count);
+                for (uint32_t k = 0; k < part.index_count; ++k)
+                {
+                    merged_indices.push_back(base + buffer.indices_[part.first_index + k]);
+                }
+            }
+            SDL_RenderGeometry(renderer, first.texture, merged_vertices.data(), static_cast<int>(merged_vertices.size()),
+                               merged_indices.data(), static_cast<int>(merged_indices.size()));
+        }
+        i = end;
+    }
+
+    if (current_clip)
+    {
+        SDL_SetRenderClipRect(renderer, nullptr);
+    }
+    for (CommandBuffer* buffer : buffers)
+    {
+        buffer->Reset();
+    }
+}
+
+}  // namespace eerium::sdl
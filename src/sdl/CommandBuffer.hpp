@@ -0,0 +1,130 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Color.hpp"
+
+namespace eerium::sdl
+{
+
+/**
+ * @brief Deferred draw commands, sorted and merged before they reach SDL
+ *
+ * Drawing code records geometry, textured quads and lines instead of calling
+ * SDL. Every command carries a sort key made of the current layer and depth:
+ * layers are drawn bottom to top, depths back to front within a layer.
+ * Commands with the same key keep the order they were recorded in, buffer by
+ * buffer. Submit() orders the commands of one or more buffers by key,
+ * concatenates neighbours that share texture and clip rectangle into a single
+ * SDL_RenderGeometry() call, and resets the buffers. Recording things that may
+ * be drawn in any order next to each other, e.g. sprites from one atlas, is
+ * what keeps the number of draw calls down.
+ *
+ * A buffer belongs to one thread while recording, so several threads can
+ * record at once into their own buffers; Submit() runs on the render thread.
+ */
+class CommandBuffer
+{
+public:
+    // Layers, drawn in this order
+    static constexpr uint8_t kLayerGround = 0;
+    static constexpr uint8_t kLayerWorld = 1;
+    static constexpr uint8_t kLayerEffects = 2;
+    static constexpr uint8_t kLayerUi = 3;
+    static constexpr uint8_t kLayerOverlay = 4;
+
+    CommandBuffer() = default;
+    ~CommandBuffer();
+
+    // Disable copy
+    CommandBuffer(const CommandBuffer&) = delete;
+    CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+    // Move semantics
+    CommandBuffer(CommandBuffer&& other) noexcept;
+    CommandBuffer& operator=(CommandBuffer&& other) noexcept;
+
+    // Sort key of the commands recorded from now on
+    void SetLayer(uint8_t layer) { layer_ = layer; }
+    void SetDepth(uint32_t depth) { depth_ = depth; }
+
+    // Clip rectangle of the commands recorded from now on, nullptr for none
+    void SetClip(const SDL_Rect* clip);
+
+    // Positions recorded from now on are scaled, then moved; clip rectangles are not
+    void SetTransform(float scale, SDL_FPoint translation)
+    {
+        scale_ = scale;
+        translation_ = translation;
+    }
+
+    // Triangles; indices refer to `vertices`
+    void Geometry(SDL_Texture* texture, std::span<const SDL_Vertex> vertices, std::span<const int> indices);
+
+    // A texture, or the `source` part of it, stretched over `dest`
+    void Texture(SDL_Texture* texture, const SDL_FRect* source, const SDL_FRect& dest,
+                 SDL_FColor tint = {1.0f, 1.0f, 1.0f, 1.0f});
+
+    void FillRect(const SDL_FRect& rect, Color color);
+
+    // Connected line segments
+    void Lines(std::span<const SDL_FPoint> points, Color color);
+
+    // Destroy a texture once the commands using it were submitted
+    void AdoptTexture(SDL_Texture* texture) { adopted_.push_back(texture); }
+
+    bool IsEmpty() const { return commands_.empty(); }
+
+    // Drop all commands and the adopted textures; key, clip and transform go back to their defaults
+    void Reset();
+
+    // Draw this buffer alone into the current render target
+    void Submit(SDL_Renderer* renderer);
+
+    // Draw several buffers as one sorted stream into the current render target
+    static void Submit(SDL_Renderer* renderer, std::span<CommandBuffer* const> buffers);
+
+private:
+    enum class Kind : uint8_t
+    {
+        GEOMETRY,
+        LINES
+    };
+
+    static constexpr uint32_t kNoClip = UINT32_MAX;
+
+    struct Command
+    {
+        uint64_t key;  // layer, then depth
+        SDL_Texture* texture;
+        uint32_t clip;
+        Kind kind;
+        SDL_FColor color;  // lines only
+        uint32_t first_vertex;
+        uint32_t vertex_count;
+        uint32_t first_index;
+        uint32_t index_count;
+    };
+
+    uint64_t Key() const { return (static_cast<uint64_t>(layer_) << 32) | depth_; }
+    bool IsTransformed() const { return scale_ != 1.0f || translation_.x != 0.0f || translation_.y != 0.0f; }
+
+    uint8_t layer_ = kLayerWorld;
+    uint32_t depth_ = 0;
+    uint32_t clip_ = kNoClip;
+    float scale_ = 1.0f;
+    SDL_FPoint translation_ = {0.0f, 0.0f};
+
+    std::vector<Command> commands_;
+    std::vector<SDL_Vertex> vertices_;
+    std::vector<int> indices_;  // relative to the first vertex of their command
+    std::vector<SDL_FPoint> points_;
+    std::vector<SDL_Rect> clips_;
+    std::vector<SDL_Texture*> adopted_;
+};
+
+}  // namespace eerium::sdl
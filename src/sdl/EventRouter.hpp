@@ -0,0 +1,207 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace eerium::sdl
+{
+
+/**
+ * @brief Routes SDL events to per-state subscribers, once per frame
+ *
+ * Poll() drains the SDL queue into a reusable frame buffer, collapsing
+ * redundant input on the way: a run of mouse motion events becomes a single
+ * event at the latest position (relative motion is summed) and a run of wheel
+ * events becomes a single event with the summed delta. Dispatch() then hands
+ * each remaining event to the handlers subscribed for the current state, so
+ * the work done per frame depends on the number of distinct inputs, not on
+ * the polling rate of the device.
+ *
+ * @tparam StateT Enum used to select the subscription table
+ * @tparam kStateCount Number of values in StateT (values must be 0..kStateCount-1)
+ */
+template <typename StateT, std::size_t kStateCount>
+class EventRouter
+{
+public:
+    using Handler = std::function<void(const SDL_Event& event)>;
+
+    /**
+     * @brief Subscribe a handler to one event type while in the given state
+     */
+    void Subscribe(StateT state, Uint32 event_type, Handler&& handler)
+    {
+        TableFor(state).by_type[event_type].emplace_back(std::move(handler));
+    }
+
+    /**
+     * @brief Subscribe the same handler to several event types while in the given state
+     */
+    void Subscribe(StateT state, std::initializer_list<Uint32> event_types, const Handler& handler)
+    {
+        for (Uint32 event_type : event_types)
+        {
+            TableFor(state).by_type[event_type].push_back(handler);
+        }
+    }
+
+    /**
+     * @brief Subscribe a handler to one event type in every state
+     *
+     * Global handlers run before the state handlers, so they may change the
+     * state the event is routed to (e.g. SDL_EVENT_QUIT).
+     */
+    void SubscribeGlobal(Uint32 event_type, Handler&& handler)
+    {
+        global_.by_type[event_type].emplace_back(std::move(handler));
+    }
+
+    /**
+     * @brief Drain the SDL event queue into the frame buffer
+     * @return Number of events left after coalescing
+     */
+    std::size_t Poll()
+    {
+        Clear();
+
+        SDL_Event event;
+        while (SDL_PollEvent(&event))
+        {
+            Push(event);
+        }
+        return frame_events_.size();
+    }
+
+    /**
+     * @brief Empty the frame buffer, for callers that Push() events themselves
+     */
+    void Clear()
+    {
+        frame_events_.clear();
+        pending_motion_.reset();
+        pending_wheel_.reset();
+    }
+
+    /**
+     * @brief Add an event to the frame buffer, coalescing it when possible
+     *
+     * Used by Poll(), and by callers that inject events from another source.
+     */
+    void Push(const SDL_Event& event)
+    {
+        switch (event.type)
+        {
+            case SDL_EVENT_MOUSE_MOTION:
+                if (pending_motion_ && CanMerge(frame_events_[*pending_motion_].motion, event.motion))
+                {
+                    SDL_MouseMotionEvent& merged = frame_events_[*pending_motion_].motion;
+                    float xrel = merged.xrel + event.motion.xrel;
+                    float yrel = merged.yrel + event.motion.yrel;
+                    merged = event.motion;
+                    merged.xrel = xrel;
+                    merged.yrel = yrel;
+                    return;
+                }
+                pending_motion_ = frame_events_.size();
+                break;
+
+            case SDL_EVENT_MOUSE_WHEEL:
+                if (pending_wheel_ && CanMerge(frame_events_[*pending_wheel_].wheel, event.wheel))
+                {
+                    SDL_MouseWheelEvent& merged = frame_events_[*pending_wheel_].wheel;
+                    merged.x += event.wheel.x;
+                    merged.y += event.wheel.y;
+                    merged.integer_x += event.wheel.integer_x;
+                    merged.integer_y += event.wheel.integer_y;
+                    merged.mouse_x = event.wheel.mouse_x;
+                    merged.mouse_y = event.wheel.mouse_y;
+                    merged.timestamp = event.wheel.timestamp;
+                    return;
+                }
+                pending_wheel_ = frame_events_.size();
+                break;
+
+            default:
+                // Anything else (buttons, keys, window events) may depend on the
+                // order of pointer input, so later motion/wheel starts a new run
+                pending_motion_.reset();
+                pending_wheel_.reset();
+                break;
+        }
+        frame_events_.push_back(event);
+    }
+
+    /**
+     * @brief Dispatch the frame buffer to the subscribers
+     * @param state Current state; read again for every event, so handlers may change it
+     */
+    void Dispatch(const StateT& state) const
+    {
+        for (const SDL_Event& event : frame_events_)
+        {
+            DispatchTo(global_, event);
+
+            auto index = static_cast<std::size_t>(state);
+            if (index < kStateCount)
+            {
+                DispatchTo(tables_[index], event);
+            }
+        }
+    }
+
+    /**
+     * @brief Events collected by the last Poll(), after coalescing
+     */
+    [[nodiscard]] const std::vector<SDL_Event>& GetFrameEvents() const noexcept { return frame_events_; }
+
+private:
+    struct SubscriptionTable
+    {
+        std::unordered_map<Uint32, std::vector<Handler>> by_type;
+    };
+
+    SubscriptionTable& TableFor(StateT state)
+    {
+        return tables_[static_cast<std::size_t>(state)];
+    }
+
+    static void DispatchTo(const SubscriptionTable& table, const SDL_Event& event)
+    {
+        auto it = table.by_type.find(event.type);
+        if (it == table.by_type.end())
+        {
+            return;
+        }
+        for (const Handler& handler : it->second)
+        {
+            handler(event);
+        }
+    }
+
+    static bool CanMerge(const SDL_MouseMotionEvent& pending, const SDL_MouseMotionEvent& next)
+    {
+        return pending.windowID == next.windowID && pending.which == next.which && pending.state == next.state;
+    }
+
+    static bool CanMerge(const SDL_MouseWheelEvent& pending, const SDL_MouseWheelEvent& next)
+    {
+        return pending.windowID == next.windowID && pending.which == next.which && pending.direction == next.direction;
+    }
+
+    std::array<SubscriptionTable, kStateCount> tables_;
+    SubscriptionTable global_;
+
+    std::vector<SDL_Event> frame_events_;
+    std::optional<std::size_t> pending_motion_;
+    std::optional<std::size_t> pending_wheel_;
+};
+
+}  // namespace eerium::sdl
@@ -115,4 +115,9 @@ int Font::GetDescent() const noexcept
     return font_ ? TTF_GetFontDescent(font_) : 0;
 }
 
+int Font::GetLineSkip() const noexcept
+{
+    return font_ ? TTF_GetFontLineSkip(font_) : 0;
+}
+
 }  // namespace eerium::sdl
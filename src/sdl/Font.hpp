@@ -109,6 +109,12 @@ public:
      */
     int GetDescent() const noexcept;
 
+    /**
+     * @brief Get recommended spacing between lines of text
+     * @return Line skip of the font in pixels, or 0 if not loaded
+     */
+    int GetLineSkip() const noexcept;
+
 private:
     TTF_Font* font_ = nullptr;
     std::string file_path_;
@@ -89,6 +89,7 @@ void FpsCounter::Render(sdl::Renderer& renderer)
     float x = window_size.width - kPadding - 150;
     float y = kPadding;
 
+    renderer.Commands().SetLayer(CommandBuffer::kLayerOverlay);
     renderer.RenderText(fps_text, x, y, kColorYellow, font_.value(),
                         Renderer::TextAlign::LEFT);
 }
@@ -0,0 +1,70 @@
+#include "RenderTarget.hpp"
+
+#include <algorithm>
+#include <string>
+
+#include "Exception.hpp"
+
+namespace eerium::sdl
+{
+
+RenderTarget::~RenderTarget()
+{
+    if (texture_)
+    {
+        SDL_DestroyTexture(texture_);
+    }
+}
+
+RenderTarget::RenderTarget(RenderTarget&& other) noexcept
+    : texture_(other.texture_), width_(other.width_), height_(other.height_)
+{
+    other.texture_ = nullptr;
+    other.width_ = 0;
+    other.height_ = 0;
+}
+
+RenderTarget& RenderTarget::operator=(RenderTarget&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (texture_)
+        {
+            SDL_DestroyTexture(texture_);
+        }
+        texture_ = other.texture_;
+        width_ = other.width_;
+        height_ = other.height_;
+        other.texture_ = nullptr;
+        other.width_ = 0;
+        other.height_ = 0;
+    }
+    return *this;
+}
+
+bool RenderTarget::Resize(SDL_Renderer* renderer, int width, int height)
+{
+    width = std::max(width, 1);
+    height = std::max(height, 1);
+    if (texture_ && width == width_ && height == height_)
+    {
+        return false;
+    }
+
+    if (texture_)
+    {
+        SDL_DestroyTexture(texture_);
+    }
+    texture_ = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!texture_)
+    {
+        width_ = 0;
+        height_ = 0;
+        throw Exception(std::string("Render target could not be created! SDL_Error: ") + SDL_GetError());
+    }
+    width_ = width;
+    height_ = height;
+    return true;
+}
+
+}  // namespace eerium::sdl
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+namespace eerium::sdl
+{
+
+/**
+ * @brief RAII wrapper for an SDL_Texture that can be rendered into
+ *
+ * The texture is created lazily by Resize() and only recreated when the
+ * size actually changes.
+ */
+class RenderTarget
+{
+public:
+    RenderTarget() = default;
+    ~RenderTarget();
+
+    // Move semantics
+    RenderTarget(RenderTarget&& other) noexcept;
+    RenderTarget& operator=(RenderTarget&& other) noexcept;
+
+    // Disable copy
+    RenderTarget(const RenderTarget&) = delete;
+    RenderTarget& operator=(const RenderTarget&) = delete;
+
+    /**
+     * @brief Make sure the texture exists with the given size
+     * @return true if the texture was (re)created, its contents are undefined then
+     */
+    bool Resize(SDL_Renderer* renderer, int width, int height);
+
+    SDL_Texture* Get() const noexcept { return texture_; }
+    operator SDL_Texture*() const noexcept { return texture_; }
+
+    int GetWidth() const noexcept { return width_; }
+    int GetHeight() const noexcept { return height_; }
+
+private:
+    SDL_Texture* texture_ = nullptr;
+    int width_ = 0;
+    int height_ = 0;
+};
+
+}  // namespace eerium::sdl
@@ -28,11 +28,13 @@ Renderer::~Renderer()
 {
     if (renderer_)
     {
+        commands_.Reset();  // adopted textures die with the renderer
         SDL_DestroyRenderer(renderer_);
     }
 }
 
-Renderer::Renderer(Renderer&& other) noexcept : renderer_(other.renderer_)
+Renderer::Renderer(Renderer&& other) noexcept
+    : renderer_(other.renderer_), commands_(std::move(other.commands_)), extra_commands_(std::move(other.extra_commands_))
 {
     other.renderer_ = nullptr;
 }
@@ -43,14 +45,30 @@ Renderer& Renderer::operator=(Renderer&& other) noexcept
     {
         if (renderer_)
         {
+            commands_.Reset();  // adopted textures die with the renderer
             SDL_DestroyRenderer(renderer_);
         }
         renderer_ = other.renderer_;
+        commands_ = std::move(other.commands_);
+        extra_commands_ = std::move(other.extra_commands_);
         other.renderer_ = nullptr;
     }
     return *this;
 }
 
+void Renderer::Flush()
+{
+    extra_commands_.insert(extra_commands_.begin(), &commands_);
+    CommandBuffer::Submit(renderer_, extra_commands_);
+    extra_commands_.clear();
+}
+
+void Renderer::Present()
+{
+    Flush();
+    SDL_RenderPresent(renderer_);
+}
+
 void Renderer::Clear(sdl::Color color)
 {
     SDL_SetRenderDrawColor(renderer_, color.r, color.g, color.b, color.a);
@@ -114,8 +132,8 @@ void Renderer::RenderText(const std::string& text,
     }
 
     SDL_FRect render_quad = {render_x, y, text_width, text_height};
-    SDL_RenderTexture(renderer_, text_texture, nullptr, &render_quad);
-    SDL_DestroyTexture(text_texture);
+    commands_.Texture(text_texture, nullptr, render_quad);
+    commands_.AdoptTexture(text_texture);
 }
 
 }  // namespace eerium::sdl
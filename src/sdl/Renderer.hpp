@@ -2,8 +2,10 @@
 #include <SDL3/SDL.h>
 
 #include <string>
+#include <vector>
 
 #include "Color.hpp"
+#include "CommandBuffer.hpp"
 #include "Font.hpp"
 
 namespace eerium::sdl
@@ -11,6 +13,10 @@ namespace eerium::sdl
 
 /**
  * @brief RAII wrapper for SDL_Renderer
+ *
+ * Drawing on the window is deferred: it is recorded into Commands() and into
+ * any buffers handed over with AddCommands(), and Present() submits all of
+ * them as one sorted stream before showing the frame.
  */
 class Renderer
 {
@@ -42,6 +48,18 @@ public:
         float height;
     };
 
+    // Commands of the render thread for the current frame
+    CommandBuffer& Commands() noexcept { return commands_; }
+
+    // Submit a buffer recorded elsewhere, e.g. on a worker thread, with this frame
+    void AddCommands(CommandBuffer& buffer) { extra_commands_.push_back(&buffer); }
+
+    // Submit the recorded commands to SDL, without showing the frame yet
+    void Flush();
+
+    // Flush() and show the frame
+    void Present();
+
     /**
      * @brief Render text using the provided font
      * @param text The text to render
@@ -60,6 +78,8 @@ public:
 
 private:
     SDL_Renderer* renderer_ = nullptr;
+    CommandBuffer commands_;
+    std::vector<CommandBuffer*> extra_commands_;
 };
 
 }  // namespace eerium::sdl
\ No newline at end of file
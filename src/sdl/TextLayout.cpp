@@ -0,0 +1,280 @@
+#include "TextLayout.hpp"
+
+#include <SDL3_ttf/SDL_ttf.h>
+
+#include <print>
+#include <utility>
+
+namespace eerium::sdl
+{
+
+TextLayout::~TextLayout()
+{
+    ReleaseTextures();
+}
+
+TextLayout::TextLayout(TextLayout&& other) noexcept
+    : text_(std::move(other.text_)),
+      font_(other.font_),
+      max_width_(other.max_width_),
+      align_(other.align_),
+      color_(other.color_),
+      lines_(std::move(other.lines_)),
+      line_height_(other.line_height_),
+      height_(other.height_),
+      layout_dirty_(other.layout_dirty_)
+{
+    other.lines_.clear();
+    other.layout_dirty_ = true;
+}
+
+TextLayout& TextLayout::operator=(TextLayout&& other) noexcept
+{
+    if (this != &other)
+    {
+        ReleaseTextures();
+        text_ = std::move(other.text_);
+        font_ = other.font_;
+        max_width_ = other.max_width_;
+        align_ = other.align_;
+        color_ = other.color_;
+        lines_ = std::move(other.lines_);
+        line_height_ = other.line_height_;
+        height_ = other.height_;
+        layout_dirty_ = other.layout_dirty_;
+        other.lines_.clear();
+        other.layout_dirty_ = true;
+    }
+    return *this;
+}
+
+void TextLayout::SetText(std::string_view text)
+{
+    if (text_ != text)
+    {
+        text_ = text;
+        Invalidate();
+    }
+}
+
+void TextLayout::SetFont(const Font& font)
+{
+    if (font_ != &font)
+    {
+        font_ = &font;
+        Invalidate();
+    }
+}
+
+void TextLayout::SetWidth(float max_width)
+{
+    if (max_width_ != max_width)
+    {
+        max_width_ = max_width;
+        Invalidate();
+    }
+}
+
+void TextLayout::SetAlign(Renderer::TextAlign align)
+{
+    // Alignment only moves lines horizontally, the line breaks stay valid
+    align_ = align;
+}
+
+void TextLayout::SetColor(Color color)
+{
+    if (color_.r != color.r || color_.g != color.g || color_.b != color.b || color_.a != color.a)
+    {
+        color_ = color;
+        // Same line breaks, but the rendered lines have to be recreated
+        ReleaseTextures();
+    }
+}
+
+const std::vector<TextLayout::Line>& TextLayout::GetLines()
+{
+    if (layout_dirty_)
+    {
+        Layout();
+    }
+    return lines_;
+}
+
+float TextLayout::GetHeight()
+{
+    if (layout_dirty_)
+    {
+        Layout();
+    }
+    return height_;
+}
+
+void TextLayout::Invalidate()
+{
+    ReleaseTextures();
+    layout_dirty_ = true;
+}
+
+void TextLayout::ReleaseTextures()
+{
+    for (Line& line : lines_)
+    {
+        if (line.texture)
+        {
+            SDL_DestroyTexture(line.texture);
+            line.texture = nullptr;
+        }
+    }
+}
+
+void TextLayout::Layout()
+{
+    ReleaseTextures();
+    lines_.clear();
+    height_ = 0.0f;
+    layout_dirty_ = false;
+
+    if (!font_ || !font_->IsValid())
+    {
+        return;
+    }
+
+    TTF_Font* font = font_->Get();
+    line_height_ = static_cast<float>(font_->GetLineSkip());
+    int max_width = max_width_ > 0.0f ? static_cast<int>(max_width_) : 0;
+
+    float y = 0.0f;
+    size_t paragraph_begin = 0;
+    while (paragraph_begin <= text_.size())
+    {
+        size_t paragraph_end = text_.find('\n', paragraph_begin);
+        if (paragraph_end == std::string::npos)
+        {
+            paragraph_end = text_.size();
+        }
+
+        size_t pos = paragraph_begin;
+        do
+        {
+            size_t remaining = paragraph_end - pos;
+            size_t fit = remaining;
+            int measured_width = 0;
+            if (remaining > 0 && max_width > 0)
+            {
+                TTF_MeasureString(font, text_.data() + pos, remaining, max_width, &measured_width, &fit);
+            }
+
+            size_t length = fit;
+            size_t next = pos + fit;
+            if (fit < remaining)
+            {
+                // Break after the last space that still fits, or mid-word if there is none
+                size_t space = text_.rfind(' ', pos + fit);
+                if (space != std::string::npos && space > pos)
+                {
+                    length = space - pos;
+                    next = space + 1;
+                }
+                else if (fit == 0)
+                {
+                    // Not even one character fits; take it anyway to guarantee progress
+                    length = 1;
+                    next = pos + 1;
+                }
+            }
+
+            // Trailing spaces do not count towards the line width
+            while (length > 0 && text_[pos + length - 1] == ' ')
+            {
+                --length;
+            }
+
+            Line line;
+            line.begin = pos;
+            line.length = length;
+            line.y = y;
+            if (length > 0)
+            {
+                int width = 0;
+                TTF_GetStringSize(font, text_.data() + pos, length, &width, nullptr);
+                line.width = static_cast<float>(width);
+            }
+            lines_.push_back(line);
+            y += line_height_;
+
+            // Wrapped lines do not start with the spaces they were broken at
+            pos = next;
+            while (pos < paragraph_end && text_[pos] == ' ')
+            {
+                ++pos;
+            }
+        } while (pos < paragraph_end);
+
+        paragraph_begin = paragraph_end + 1;
+    }
+
+    height_ = y;
+}
+
+void TextLayout::Render(Renderer& renderer, float x, float y, float clip_top, float clip_bottom)
+{
+    if (layout_dirty_)
+    {
+        Layout();
+    }
+
+    for (Line& line : lines_)
+    {
+        float line_top = y + line.y;
+        if (line_top + line_height_ <= clip_top)
+        {
+            continue;
+        }
+        if (line_top >= clip_bottom)
+        {
+            break;  // lines are sorted top to bottom
+        }
+        if (line.length == 0)
+        {
+            continue;
+        }
+
+        if (!line.texture)
+        {
+            SDL_Surface* surface = TTF_RenderText_Blended(font_->Get(), text_.data() + line.begin, line.length, color_);
+            if (!surface)
+            {
+                std::println(stderr, "Unable to render text line! SDL_Error: {}", SDL_GetError());
+                continue;
+            }
+            line.texture = SDL_CreateTextureFromSurface(renderer, surface);
+            SDL_DestroySurface(surface);
+            if (!line.texture)
+            {
+                std::println(stderr, "Unable to create texture from text line! SDL_Error: {}", SDL_GetError());
+                continue;
+            }
+        }
+
+        float line_x = x;
+        switch (align_)
+        {
+            case Renderer::TextAlign::LEFT:
+                break;
+            case Renderer::TextAlign::CENTER:
+                line_x = x + (max_width_ - line.width) / 2.0f;
+                break;
+            case Renderer::TextAlign::RIGHT:
+                line_x = x + max_width_ - line.width;
+                break;
+        }
+
+        float texture_width = 0.0f;
+        float texture_height = 0.0f;
+        SDL_GetTextureSize(line.texture, &texture_width, &texture_height);
+        SDL_FRect dest = {line_x, line_top, texture_width, texture_height};
+        renderer.Commands().Texture(line.texture, nullptr, dest);
+    }
+}
+
+}  // namespace eerium::sdl
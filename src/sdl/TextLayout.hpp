@@ -0,0 +1,103 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Color.hpp"
+#include "Font.hpp"
+#include "Renderer.hpp"
+
+namespace eerium::sdl
+{
+
+/**
+ * @brief Word-wrapped, aligned multi-line text with cached line textures
+ *
+ * The text is broken into lines for a given font and maximum width. The
+ * layout and the rendered line textures are kept until the text, font,
+ * width, alignment or color changes, so drawing a static page each frame
+ * only blits the textures of the visible lines.
+ */
+class TextLayout
+{
+public:
+    struct Line
+    {
+        size_t begin = 0;      // byte offset into the text
+        size_t length = 0;     // byte length, without the trailing break
+        float width = 0.0f;    // rendered width in pixels
+        float y = 0.0f;        // top of the line, relative to the layout
+        SDL_Texture* texture = nullptr;  // created on first draw
+    };
+
+    TextLayout() = default;
+    ~TextLayout();
+
+    // Move semantics
+    TextLayout(TextLayout&& other) noexcept;
+    TextLayout& operator=(TextLayout&& other) noexcept;
+
+    // Disable copy
+    TextLayout(const TextLayout&) = delete;
+    TextLayout& operator=(const TextLayout&) = delete;
+
+    /**
+     * @brief Set the text; '\n' starts a new paragraph
+     */
+    void SetText(std::string_view text);
+
+    /**
+     * @brief Set the font used for measuring and rendering
+     * @param font Font to use, must outlive the layout
+     */
+    void SetFont(const Font& font);
+
+    /**
+     * @brief Set the maximum line width in pixels
+     */
+    void SetWidth(float max_width);
+
+    void SetAlign(Renderer::TextAlign align);
+    void SetColor(Color color);
+
+    /**
+     * @brief Get the laid out lines, re-laying out first if anything changed
+     */
+    const std::vector<Line>& GetLines();
+
+    /**
+     * @brief Get the total height of the laid out text in pixels
+     */
+    float GetHeight();
+
+    /**
+     * @brief Render the lines that intersect the vertical range [clip_top, clip_bottom)
+     * @param renderer The renderer to use for drawing
+     * @param x Left edge of the layout box
+     * @param y Top of the layout box (may be above clip_top when scrolled)
+     * @param clip_top Screen y above which lines are skipped
+     * @param clip_bottom Screen y below which lines are skipped
+     */
+    void Render(Renderer& renderer, float x, float y, float clip_top, float clip_bottom);
+
+private:
+    void Layout();
+    void ReleaseTextures();
+    void Invalidate();
+
+    std::string text_;
+    const Font* font_ = nullptr;
+    float max_width_ = 0.0f;
+    Renderer::TextAlign align_ = Renderer::TextAlign::LEFT;
+    Color color_ = {255, 255, 255, 255};
+
+    std::vector<Line> lines_;
+    float line_height_ = 0.0f;
+    float height_ = 0.0f;
+    bool layout_dirty_ = true;
+};
+
+}  // namespace eerium::sdl
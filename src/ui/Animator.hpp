@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <unordered_map>
+#include <vector>
+
+#include "sdl/Color.hpp"
+
+namespace eerium::ui
+{
+
+enum class Easing : uint8_t {
+    Linear,
+    EaseOut,
+    EaseInOut,
+    Pulse  // goes to the target value and back to the start
+};
+
+// Color stored as floats so each channel can be tweened independently
+struct AnimatedColor {
+    float r = 0.0f;
+    float g = 0.0f;
+    float b = 0.0f;
+    float a = 255.0f;
+
+    AnimatedColor() = default;
+    AnimatedColor(sdl::Color color) { Set(color); }
+
+    void Set(sdl::Color color) noexcept {
+        r = color.r;
+        g = color.g;
+        b = color.b;
+        a = color.a;
+    }
+
+    [[nodiscard]] sdl::Color Get() const noexcept {
+        return {ToChannel(r), ToChannel(g), ToChannel(b), ToChannel(a)};
+    }
+
+private:
+    static Uint8 ToChannel(float value) noexcept {
+        return static_cast<Uint8>(std::clamp(value + 0.5f, 0.0f, 255.0f));
+    }
+};
+
+/**
+ * Time-based tweens of float values (colors, scales, offsets).
+ *
+ * Active tweens live in flat parallel arrays and are advanced together by a
+ * single Update() per frame; finished tweens are swap-removed, so elements
+ * that are not animating cost nothing. Owners must Cancel() their targets
+ * before the animated floats go out of scope.
+ */
+class Animator
+{
+public:
+    static Animator& Instance() {
+        static Animator instance;
+        return instance;
+    }
+
+    // Largest time step applied per update, so a frame after an idle period
+    // does not skip animations that were just started
+    static constexpr float kMaxTimeStep = 1.0f / 30.0f;
+
+    // Tween *target from its current value to `to`; replaces any tween already on target
+    void Animate(float* target, float to, float duration, Easing easing = Easing::EaseOut) {
+        if (duration <= 0.0f) {
+            Cancel(target);
+            *target = to;
+            return;
+        }
+
+        size_t index;
+        auto it = index_.find(target);
+        if (it != index_.end()) {
+            index = it->second;
+        } else {
+            index = targets_.size();
+            index_.emplace(target, index);
+            targets_.push_back(target);
+            from_.push_back(0.0f);
+            to_.push_back(0.0f);
+            elapsed_.push_back(0.0f);
+            inv_duration_.push_back(0.0f);
+            easing_.push_back(Easing::Linear);
+        }
+
+        // A replaced tween continues from where it currently is
+        from_[index] = *target;
+        to_[index] = to;
+        elapsed_[index] = 0.0f;
+        inv_duration_[index] = 1.0f / duration;
+        easing_[index] = easing;
+    }
+
+    // Go from `rest` to `peak` and back within `duration`. A pulse always ends where it
+    // started, so the rest value is explicit: a pulse that replaces a running one would
+    // otherwise start, and end, at the raised value.
+    void Pulse(float* target, float rest, float peak, float duration) {
+        if (duration <= 0.0f) {
+            Cancel(target);
+            *target = rest;
+            return;
+        }
+        Animate(target, peak, duration, Easing::Pulse);
+        from_[index_.at(target)] = rest;
+    }
+
+    void Fade(AnimatedColor& color, sdl::Color to, float duration, Easing easing = Easing::EaseOut) {
+        Animate(&color.r, to.r, duration, easing);
+        Animate(&color.g, to.g, duration, easing);
+        Animate(&color.b, to.b, duration, easing);
+        Animate(&color.a, to.a, duration, easing);
+    }
+
+    void Cancel(float* target) {
+        auto it = index_.find(target);
+        if (it != index_.end()) {
+            Remove(it->second);
+        }
+    }
+
+    void Cancel(AnimatedColor& color) {
+        Cancel(&color.r);
+        Cancel(&color.g);
+        Cancel(&color.b);
+        Cancel(&color.a);
+    }
+
+    // Advance all active tweens; finished ones snap to their end value and are removed
+    void Update(float delta_seconds) {
+        const float dt = std::min(delta_seconds, kMaxTimeStep);
+        const size_t count = targets_.size();
+
+        for (size_t i = 0; i < count; ++i) {
+            elapsed_[i] = std::min(1.0f, elapsed_[i] + dt * inv_duration_[i]);
+            *targets_[i] = from_[i] + (to_[i] - from_[i]) * Ease(easing_[i], elapsed_[i]);
+        }
+
+        // Remove back to front so swap-removal never skips an element
+        for (size_t i = count; i-- > 0;) {
+            if (elapsed_[i] >= 1.0f) {
+                Remove(i);
+            }
+        }
+    }
+
+    [[nodiscard]] bool IsAnimating() const noexcept { return !targets_.empty(); }
+    [[nodiscard]] bool IsAnimating(const float* target) const { return index_.contains(target); }
+    [[nodiscard]] size_t GetActiveCount() const noexcept { return targets_.size(); }
+
+    Animator(const Animator&) = delete;
+    Animator& operator=(const Animator&) = delete;
+
+private:
+    Animator() = default;
+
+    static float Ease(Easing easing, float t) noexcept {
+        switch (easing) {
+            case Easing::Linear:
+                return t;
+            case Easing::EaseOut:
+                return 1.0f - (1.0f - t) * (1.0f - t);
+            case Easing::EaseInOut:
+                return t * t * (3.0f - 2.0f * t);
+            case Easing::Pulse:
+                return std::sin(t * std::numbers::pi_v<float>);
+        }
+        return t;
+    }
+
+    void Remove(size_t index) {
+        index_.erase(targets_[index]);
+
+        size_t last = targets_.size() - 1;
+        if (index != last) {
+            targets_[index] = targets_[last];
+            from_[index] = from_[last];
+            to_[index] = to_[last];
+            elapsed_[index] = elapsed_[last];
+            inv_duration_[index] = inv_duration_[last];
+            easing_[index] = easing_[last];
+            index_[targets_[index]] = index;
+        }
+
+        targets_.pop_back();
+        from_.pop_back();
+        to_.pop_back();
+        elapsed_.pop_back();
+        inv_duration_.pop_back();
+        easing_.pop_back();
+    }
+
+    // Structure-of-arrays storage, one entry per active tween
+    std::vector<float*> targets_;
+    std::vector<float> from_;
+    std::vector<float> to_;
+    std::vector<float> elapsed_;  // normalized progress 0..1
+    std::vector<float> inv_duration_;
+    std::vector<Easing> easing_;
+
+    std::unordered_map<const float*, size_t> index_;
+};
+
+}  // namespace eerium::ui
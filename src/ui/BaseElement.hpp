@@ -21,6 +21,8 @@ struct ElementState {
     bool focused = false;
     bool pressed = false;
     bool enabled = true;
+
+    bool operator==(const ElementState&) const = default;
 };
 
 class BaseElement
@@ -5,6 +5,7 @@
 
 #include "sdl/Color.hpp"
 #include "sdl/ResourceManager.hpp"
+#include "ui/Animator.hpp"
 #include "ui/BaseElement.hpp"
 #include <SDL3_ttf/SDL_ttf.h>
 
@@ -39,6 +40,15 @@ public:
 
         // Calculate proper size based on text
         UpdateSize();
+        current_color_.Set(colors_.normal);
+    }
+
+    ~ClickableText() override
+    {
+        auto& animator = Animator::Instance();
+        animator.Cancel(current_color_);
+        animator.Cancel(&scale_);
+        animator.Cancel(&slide_x_);
     }
 
     // Modern string handling
@@ -53,6 +63,8 @@ public:
     void SetColorScheme(const ColorScheme& scheme) noexcept
     {
         colors_ = scheme;
+        Animator::Instance().Cancel(current_color_);
+        current_color_.Set(GetCurrentTextColor());
     }
 
     void SetPadding(float horizontal, float vertical) noexcept
@@ -74,8 +86,8 @@ public:
         auto font = sdl::ResourceManager::Instance().GetDefaultFont();
         if (!font || !font->IsValid()) return;
 
-        // Choose text color based on state
-        const sdl::Color text_color = GetCurrentTextColor();
+        // Text color follows the state, faded by the animator
+        const sdl::Color text_color = current_color_.Get();
 
         // Create text surface using SDL_ttf directly
         SDL_Surface* text_surface = TTF_RenderText_Blended(font->Get(), text_.c_str(), text_.length(), text_color);
@@ -95,18 +107,33 @@ public:
         float text_x, text_y;
         CalculateTextPositionWithDimensions(text_x, text_y, actual_text_width, actual_text_height);
 
-        // Render the texture with actual dimensions
-        SDL_FRect dest_rect = {text_x, text_y, actual_text_width, actual_text_height};
-        SDL_RenderTexture(renderer.Get(), text_texture, nullptr, &dest_rect);
-
-        SDL_DestroyTexture(text_texture);
+        // Render the texture with actual dimensions, scaled around its center
+        float scaled_width = actual_text_width * scale_;
+        float scaled_height = actual_text_height * scale_;
+        SDL_FRect dest_rect = {text_x + slide_x_ - (scaled_width - actual_text_width) / 2.0f,
+                               text_y - (scaled_height - actual_text_height) / 2.0f,
+                               scaled_width, scaled_height};
+        renderer.Commands().Texture(text_texture, nullptr, dest_rect);
+        renderer.Commands().AdoptTexture(text_texture);
     }
 
 protected:
     void OnStateChanged(const ElementState& old_state, const ElementState& new_state) override
     {
-        // Could add animation triggers here, sound effects, etc.
-        // For now, just visual feedback is handled in Render()
+        auto& animator = Animator::Instance();
+
+        // Fade towards the color of the new state
+        animator.Fade(current_color_, GetCurrentTextColor(), kColorFadeSeconds);
+
+        // Short pulse when the element gains focus, slide towards the focus offset
+        if (new_state.focused && !old_state.focused)
+        {
+            animator.Pulse(&scale_, 1.0f, kFocusPulseScale, kFocusPulseSeconds);
+        }
+        if (new_state.focused != old_state.focused)
+        {
+            animator.Animate(&slide_x_, new_state.focused ? kFocusSlideOffset : 0.0f, kFocusSlideSeconds);
+        }
     }
 
 private:
@@ -116,8 +143,19 @@ private:
         float vertical = 5.0f;
     } padding_;
 
+    static constexpr float kColorFadeSeconds = 0.15f;
+    static constexpr float kFocusPulseScale = 1.12f;
+    static constexpr float kFocusPulseSeconds = 0.25f;
+    static constexpr float kFocusSlideOffset = 4.0f;
+    static constexpr float kFocusSlideSeconds = 0.12f;
+
     std::string text_;
     ColorScheme colors_;
+
+    // Animated presentation state
+    AnimatedColor current_color_;
+    float scale_ = 1.0f;
+    float slide_x_ = 0.0f;
     TextAlignment alignment_ = TextAlignment::Center;
     int text_width_ = 0;
     int text_height_ = 0;
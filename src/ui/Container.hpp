@@ -27,12 +27,14 @@ public:
         auto element = std::make_unique<ElementType>(std::forward<Args>(args)...);
         ElementType& ref = *element;
         elements_.emplace_back(std::move(element));
+        dirty_ = true;
         return ref;
     }
     
     void AddElement(std::unique_ptr<BaseElement> element) {
         if (element) {
             elements_.emplace_back(std::move(element));
+            dirty_ = true;
         }
     }
     
@@ -40,6 +42,7 @@ public:
         elements_.clear();
         selected_index_ = std::nullopt;
         hovered_index_ = std::nullopt;
+        dirty_ = true;
     }
 
     void Render(sdl::Renderer& renderer) {
@@ -47,8 +50,13 @@ public:
         for (const auto& element : elements_) {
             element->Render(renderer);
         }
+        dirty_ = false;
     }
 
+    // True when an element changed its visual state since the last Render()
+    [[nodiscard]] bool IsDirty() const noexcept { return dirty_; }
+    void MarkDirty() noexcept { dirty_ = true; }
+
     void HandleEvent(const SDL_Event& event) {
         switch (event.type) {
             case SDL_EVENT_MOUSE_MOTION:
@@ -152,6 +160,7 @@ private:
     std::vector<std::unique_ptr<BaseElement>> elements_;
     std::optional<size_t> selected_index_;
     std::optional<size_t> hovered_index_;
+    bool dirty_ = true;
     
     void UpdateLayout() {
         if (elements_.empty()) return;
@@ -267,7 +276,10 @@ private:
             state.focused = (selected_index_ && *selected_index_ == i);
             state.enabled = true; // Could be configurable per element
             
-            elements_[i]->SetState(state);
+            if (elements_[i]->GetState() != state) {
+                elements_[i]->SetState(state);
+                dirty_ = true;
+            }
         }
     }
 };